@@ -0,0 +1,274 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_BATCH_HPP
+#define CRAFT_EXTRACT_BATCH_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "extract.hpp"
+#include "writers.hpp"
+
+namespace craft_extract::batch
+{
+    /**
+     * Batch Job Structure Definitions
+     */
+
+    struct job_t
+    {
+        std::string input;
+        std::vector<craft_extract::target_t> targets;
+    };
+
+    /**
+     * Returns if the given name matches the given wildcard pattern. (Supports '*' and '?'; case-insensitive.)
+     *
+     * @param {std::string_view} pattern - The wildcard pattern.
+     * @param {std::string_view} name - The name to match.
+     * @return {bool} True if the name matches, false otherwise.
+     */
+    inline bool matches(std::string_view pattern, std::string_view name)
+    {
+        const auto equal = [](const char a, const char b) {
+            return std::tolower(static_cast<uint8_t>(a)) == std::tolower(static_cast<uint8_t>(b));
+        };
+
+        std::size_t p = 0, n = 0, star = std::string_view::npos, mark = 0;
+
+        while (n < name.size())
+        {
+            if (p < pattern.size() && (pattern[p] == '?' || equal(pattern[p], name[n])))
+            {
+                p++;
+                n++;
+            }
+            else if (p < pattern.size() && pattern[p] == '*')
+            {
+                star = p++;
+                mark = n;
+            }
+            else if (star != std::string_view::npos)
+            {
+                p = star + 1;
+                n = ++mark;
+            }
+            else
+                return false;
+        }
+
+        while (p < pattern.size() && pattern[p] == '*')
+            p++;
+
+        return p == pattern.size();
+    }
+
+    /**
+     * Collects the batch jobs described by the given source.
+     *
+     * The source can be one of the following:
+     *  - A directory; every .crf file within it (recursively) is extracted, mirroring the directory layout in the output directory.
+     *  - A wildcard pattern; every file in the patterns directory whose name matches the pattern is extracted.
+     *  - A manifest file; each line holds an input file path, optionally followed by a tab and the output file path.
+     *    Empty lines and lines starting with '#' are ignored. Relative output paths are relative to the output directory.
+     *
+     * Output files are named after their input file, without its extension, followed by the extension of each mode.
+     * Output file paths given in a manifest are used as with --out. (See craft_extract::targets.)
+     *
+     * @param {std::string} source - The batch source.
+     * @param {std::string} output_dir - The output directory to save the extracted craft information into.
+     * @param {std::vector<output_mode>} modes - The output file formats to use when saving.
+     * @param {std::vector<job_t>} jobs - The container to store the collected jobs into.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool collect(const std::string& source, const std::string& output_dir, const std::vector<craft_extract::output_mode>& modes, std::vector<craft_extract::batch::job_t>& jobs)
+    {
+        namespace fs = std::filesystem;
+
+        // History databases are appended to under a single version key; they cannot be the target of a batch..
+        if (std::ranges::find(modes, craft_extract::output_mode::history) != modes.end())
+        {
+            std::cout << "[!] Error: History mode cannot be used in batch mode; extract each version on its own." << std::endl;
+            return false;
+        }
+
+        const fs::path src(source);
+        const fs::path out(output_dir);
+
+        std::error_code ec;
+        jobs.clear();
+
+        if (fs::is_directory(src, ec))
+        {
+            for (auto iter = fs::recursive_directory_iterator(src, ec), iterend = fs::recursive_directory_iterator(); !ec && iter != iterend; iter.increment(ec))
+            {
+                if (!iter->is_regular_file(ec))
+                    continue;
+
+                auto extension = iter->path().extension().string();
+                std::ranges::transform(extension, extension.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<uint8_t>(c))); });
+                if (extension != ".crf")
+                    continue;
+
+                auto relative = iter->path().lexically_relative(src);
+                relative.replace_extension();
+
+                jobs.push_back({iter->path().string(), craft_extract::mode_targets((out / relative).string(), modes)});
+            }
+        }
+        else if (src.filename().string().find_first_of("*?") != std::string::npos)
+        {
+            const auto dir     = src.has_parent_path() ? src.parent_path() : fs::path(".");
+            const auto pattern = src.filename().string();
+
+            for (auto iter = fs::directory_iterator(dir, ec), iterend = fs::directory_iterator(); !ec && iter != iterend; iter.increment(ec))
+            {
+                if (!iter->is_regular_file(ec) || !matches(pattern, iter->path().filename().string()))
+                    continue;
+
+                jobs.push_back({iter->path().string(), craft_extract::mode_targets((out / iter->path().stem()).string(), modes)});
+            }
+        }
+        else if (fs::is_regular_file(src, ec))
+        {
+            std::ifstream ifs(src);
+            std::string line;
+
+            while (std::getline(ifs, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                if (line.empty() || line.front() == '#')
+                    continue;
+
+                const auto tab = line.find('\t');
+                const fs::path input(line.substr(0, tab));
+
+                if (tab == std::string::npos)
+                    jobs.push_back({input.string(), craft_extract::mode_targets((out / input.stem()).string(), modes)});
+                else
+                    jobs.push_back({input.string(), craft_extract::targets((out / line.substr(tab + 1)).string(), modes)});
+            }
+        }
+        else
+        {
+            std::cout << "[!] Error: Invalid batch source given; expected a directory, wildcard pattern or manifest file." << std::endl;
+            return false;
+        }
+
+        if (ec)
+        {
+            std::cout << std::format("[!] Error: Failed to collect batch input files: {}", ec.message()) << std::endl;
+            return false;
+        }
+
+        // Sort the jobs for a stable processing order..
+        std::ranges::sort(jobs, {}, &craft_extract::batch::job_t::input);
+
+        // Ensure no two jobs write to the same output file..
+        std::vector<std::string> outputs;
+        outputs.reserve(jobs.size());
+        for (const auto& job : jobs)
+        {
+            for (const auto& target : job.targets)
+                outputs.push_back(fs::path(target.output).lexically_normal().string());
+        }
+
+        std::ranges::sort(outputs);
+        if (const auto dupe = std::ranges::adjacent_find(outputs); dupe != outputs.end())
+        {
+            std::cout << std::format("[!] Error: Multiple batch inputs would be saved to the same output file: {}", *dupe) << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Runs the given batch jobs on a pool of worker threads.
+     *
+     * @param {std::vector<job_t>} jobs - The jobs to run.
+     * @param {std::size_t} workers - The number of worker threads to use. (0 to use one per hardware thread.)
+     * @param {parse_options} filters - The parsing options. (Only the filters are used.)
+     * @param {save_options} settings - The saving options.
+     * @return {std::size_t} The number of jobs that failed.
+     */
+    inline std::size_t run(const std::vector<craft_extract::batch::job_t>& jobs, std::size_t workers, const craft_extract::parse_options& filters, const craft_extract::save_options& settings)
+    {
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        workers = std::min(workers, jobs.size());
+
+        // Files are already processed in parallel; avoid oversubscribing the machine with realm and writer threads..
+        auto options            = filters;
+        options.parallel_realms = false;
+
+        auto saving             = settings;
+        saving.parallel_writers = workers == 1;
+
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> failed{0};
+        std::mutex console;
+
+        const auto worker = [&]() {
+            for (auto index = next++; index < jobs.size(); index = next++)
+            {
+                const auto& job = jobs[index];
+
+                // Ensure the output directories exist..
+                std::string outputs;
+                for (const auto& target : job.targets)
+                {
+                    std::error_code ec;
+                    const auto parent = std::filesystem::path(target.output).parent_path();
+                    if (!parent.empty())
+                        std::filesystem::create_directories(parent, ec);
+
+                    outputs += outputs.empty() ? target.output : ", " + target.output;
+                }
+
+                const auto result = craft_extract::extract(job.input, job.targets, options, saving);
+                if (result == craft_extract::extract_result::failed)
+                    failed++;
+
+                const auto status = result == craft_extract::extract_result::extracted   ? "Extracted:"
+                                    : result == craft_extract::extract_result::unchanged ? "Unchanged:"
+                                                                                         : "Failed:";
+
+                std::lock_guard<std::mutex> lock(console);
+                std::cout << std::format("[!] {} {} -> {}", status, job.input, outputs) << std::endl;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (auto x = 0u; x < workers; x++)
+            threads.emplace_back(worker);
+        for (auto& t : threads)
+            t.join();
+
+        return failed;
+    }
+
+} // namespace craft_extract::batch
+
+#endif // CRAFT_EXTRACT_BATCH_HPP
@@ -0,0 +1,182 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_CACHE_HPP
+#define CRAFT_EXTRACT_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "hash.hpp"
+#include "mapped_file.hpp"
+
+namespace craft_extract::cache
+{
+    /**
+     * Returns the path of the sidecar cache file of the given output file.
+     *
+     * @param {std::string} output - The output file.
+     * @return {std::string} The cache file path.
+     */
+    inline std::string path(const std::string& output)
+    {
+        return output + ".cache";
+    }
+
+    /**
+     * Computes the content hash of the given input file.
+     *
+     * @param {std::string} input - The input file to hash.
+     * @param {uint64_t} hash - The computed hash.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool hash_file(const std::string& input, uint64_t& hash)
+    {
+        craft_extract::mapped_file file;
+        if (!file.open(input))
+            return false;
+
+        const auto data = file.span();
+
+        hash = craft_extract::content_hash(data.data(), data.size());
+        return true;
+    }
+
+    /**
+     * Builds the cache key of an extraction.
+     *
+     * The key records everything that affects the output file: the input contents, the output mode, the tool version
+     * and the options that change what is extracted.
+     *
+     * @param {uint64_t} hash - The content hash of the input file.
+     * @param {output_mode} mode - The output file format.
+     * @param {parse_options} options - The parsing options.
+     * @param {save_options} settings - The saving options.
+     * @return {std::string} The cache key.
+     */
+    inline std::string key(const uint64_t hash, const craft_extract::output_mode mode, const craft_extract::parse_options& options, const craft_extract::save_options& settings)
+    {
+        return std::format("hash={:016X}\nmode={}\ntool={}\nrealm={}\nprofession={}\ncategory={}\nmaterial={}\nskill={}-{}\nlevel={}-{}\nversion={}\n",
+            hash,
+            static_cast<int32_t>(mode),
+            craft_extract::tool_version,
+            options.realm,
+            options.profession,
+            options.category,
+            options.material,
+            options.min_skill,
+            options.max_skill,
+            options.min_level,
+            options.max_level,
+            settings.version);
+    }
+
+    /**
+     * Builds the stamp of the given output file; its size and last write time.
+     *
+     * The stamp is recorded alongside the cache key once the output file is written, so output files that were
+     * modified or replaced since are not mistaken for up to date.
+     *
+     * @param {std::string} output - The output file.
+     * @param {std::string} stamp - The output file stamp.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool stamp(const std::string& output, std::string& stamp)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(output, ec))
+            return false;
+
+        const auto size = std::filesystem::file_size(output, ec);
+        if (ec)
+            return false;
+
+        const auto time = std::filesystem::last_write_time(output, ec);
+        if (ec)
+            return false;
+
+        stamp = std::format("size={}\nmtime={}\n", size, time.time_since_epoch().count());
+        return true;
+    }
+
+    /**
+     * Returns if the given output file is up to date with the given cache key.
+     *
+     * @param {std::string} output - The output file.
+     * @param {std::string} key - The cache key of the extraction.
+     * @return {bool} True if the output file was produced by an extraction with the same key and is unchanged since, false otherwise.
+     */
+    inline bool fresh(const std::string& output, const std::string& key)
+    {
+        std::string expected;
+        if (!craft_extract::cache::stamp(output, expected))
+            return false;
+
+        expected.insert(0, key);
+
+        std::ifstream ifs(craft_extract::cache::path(output), std::ios::binary);
+        if (!ifs.is_open())
+            return false;
+
+        std::string str(expected.size() + 1, '\0');
+        ifs.read(str.data(), static_cast<std::streamsize>(str.size()));
+        str.resize(static_cast<std::size_t>(ifs.gcount()));
+
+        return str == expected;
+    }
+
+    /**
+     * Removes the sidecar cache file of the given output file.
+     *
+     * @param {std::string} output - The output file.
+     */
+    inline void invalidate(const std::string& output)
+    {
+        std::error_code ec;
+        std::filesystem::remove(craft_extract::cache::path(output), ec);
+    }
+
+    /**
+     * Writes the sidecar cache file of the given output file; called once the output file has been written.
+     *
+     * @param {std::string} output - The output file.
+     * @param {std::string} key - The cache key of the extraction that produced the output file.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool store(const std::string& output, const std::string& key)
+    {
+        std::string stamp;
+        if (!craft_extract::cache::stamp(output, stamp))
+            return false;
+
+        std::ofstream ofs(craft_extract::cache::path(output), std::ios::binary);
+        if (!ofs.is_open())
+            return false;
+
+        ofs << key << stamp;
+        ofs.close();
+
+        return !ofs.fail();
+    }
+
+} // namespace craft_extract::cache
+
+#endif // CRAFT_EXTRACT_CACHE_HPP
@@ -0,0 +1,258 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "cache.hpp"
+#include "craft_extract.h"
+#include "crafts.hpp"
+#include "loader.hpp"
+#include "recipe_reader.hpp"
+#include "writers.hpp"
+
+static_assert(CRAFT_EXTRACT_MAX_MATERIALS == decltype(craft_extract::craft_t::materials)::capacity(), "CRAFT_EXTRACT_MAX_MATERIALS must match craft_t.");
+static_assert(CRAFT_EXTRACT_MODE_SNAPSHOT == static_cast<int32_t>(craft_extract::output_mode::snapshot), "C API modes must match output_mode.");
+
+/**
+ * Opaque Handle Definitions
+ */
+
+struct craft_extract_file_t
+{
+    craft_extract::parse_result result;
+    std::vector<const craft_extract::craft_t*> recipes;
+};
+
+struct craft_extract_reader_t
+{
+    craft_extract::recipe_reader reader;
+    craft_extract::craft_t craft;
+};
+
+namespace craft_extract::capi
+{
+    /**
+     * Returns a C string view of the given string.
+     *
+     * @param {std::string_view} str - The string.
+     * @return {craft_extract_string_t} The C string view.
+     */
+    craft_extract_string_t view(const std::string_view str)
+    {
+        return {str.data(), str.size()};
+    }
+
+    /**
+     * Returns a C string view of the given string table entry.
+     *
+     * @param {string_table} strings - The string table.
+     * @param {uint32_t} index - The index of the string.
+     * @return {craft_extract_string_t} The C string view, empty if the index is invalid.
+     */
+    craft_extract_string_t view(const craft_extract::string_table& strings, const uint32_t index)
+    {
+        return index < strings.size() ? view(strings[index]) : craft_extract_string_t{};
+    }
+
+    /**
+     * Converts the given C filter into parsing options.
+     *
+     * @param {craft_extract_filter_t} filter - The filter to convert. (May be null.)
+     * @return {parse_options} The parsing options.
+     */
+    craft_extract::parse_options options(const craft_extract_filter_t* filter)
+    {
+        craft_extract::parse_options options{};
+        if (filter == nullptr)
+            return options;
+
+        options.realm      = filter->realm;
+        options.profession = filter->profession != nullptr ? filter->profession : "";
+        options.category   = filter->category != nullptr ? filter->category : "";
+        options.material   = filter->material != nullptr ? filter->material : "";
+        options.min_skill  = filter->min_skill;
+        options.max_skill  = filter->max_skill;
+        options.min_level  = filter->min_level;
+        options.max_level  = filter->max_level;
+
+        return options;
+    }
+
+    /**
+     * Converts the given craft recipe entry into a C recipe.
+     *
+     * @param {string_table} strings - The string table of the recipe.
+     * @param {craft_t} craft - The craft recipe entry to convert.
+     * @param {craft_extract_recipe_t} recipe - The C recipe to store the converted recipe into.
+     */
+    void convert(const craft_extract::string_table& strings, const craft_extract::craft_t& craft, craft_extract_recipe_t& recipe)
+    {
+        recipe                = {};
+        recipe.realm          = craft.name_index_realm;
+        recipe.id             = craft.id;
+        recipe.realm_name     = view(craft.name_index_realm < craft_extract::realm_names.size() ? craft_extract::realm_names[craft.name_index_realm] : std::string_view());
+        recipe.profession     = view(strings, craft.name_index_profession);
+        recipe.category       = view(strings, craft.name_index_category);
+        recipe.name           = view(strings, craft.name_index_recipe);
+        recipe.base_material  = craft.base_material;
+        recipe.icon           = craft.icon;
+        recipe.level          = craft.level;
+        recipe.material_level = craft.material_level;
+        recipe.skill          = craft.skill;
+        recipe.material_count = static_cast<uint32_t>(craft.materials.size());
+
+        for (auto x = 0u; x < craft.materials.size(); x++)
+        {
+            recipe.materials[x].base_material = craft.materials[x].base_material;
+            recipe.materials[x].count         = craft.materials[x].count;
+            recipe.materials[x].name          = view(strings, craft.materials[x].name_index);
+        }
+    }
+
+} // namespace craft_extract::capi
+
+extern "C" {
+
+CRAFT_EXTRACT_API const char* craft_extract_version(void)
+{
+    return craft_extract::tool_version;
+}
+
+CRAFT_EXTRACT_API void craft_extract_filter_init(craft_extract_filter_t* filter)
+{
+    if (filter == nullptr)
+        return;
+
+    const craft_extract::parse_options options{};
+
+    *filter           = {};
+    filter->realm     = options.realm;
+    filter->min_skill = options.min_skill;
+    filter->max_skill = options.max_skill;
+    filter->min_level = options.min_level;
+    filter->max_level = options.max_level;
+}
+
+CRAFT_EXTRACT_API int32_t craft_extract_parse(const char* path, const craft_extract_filter_t* filter, craft_extract_file_t** file)
+{
+    if (path == nullptr || file == nullptr)
+        return 0;
+
+    *file = nullptr;
+
+    try
+    {
+        auto f = std::make_unique<craft_extract_file_t>();
+        if (!craft_extract::load(path, craft_extract::capi::options(filter), f->result))
+            return 0;
+
+        // Index the recipes for random access, in realm order..
+        for (const auto& r : f->result.crafts)
+        {
+            for (const auto& craft : r.second)
+                f->recipes.push_back(&craft);
+        }
+
+        *file = f.release();
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << std::format("[!] Error: Failed to parse input file: {}", e.what()) << std::endl;
+        return 0;
+    }
+}
+
+CRAFT_EXTRACT_API size_t craft_extract_count(const craft_extract_file_t* file)
+{
+    return file != nullptr ? file->recipes.size() : 0;
+}
+
+CRAFT_EXTRACT_API int32_t craft_extract_recipe(const craft_extract_file_t* file, size_t index, craft_extract_recipe_t* recipe)
+{
+    if (file == nullptr || recipe == nullptr || index >= file->recipes.size())
+        return 0;
+
+    craft_extract::capi::convert(file->result.strings, *file->recipes[index], *recipe);
+    return 1;
+}
+
+CRAFT_EXTRACT_API int32_t craft_extract_write(const craft_extract_file_t* file, const char* path, int32_t mode, const char* version)
+{
+    if (file == nullptr || path == nullptr || mode < CRAFT_EXTRACT_MODE_CSV || mode > CRAFT_EXTRACT_MODE_SNAPSHOT)
+        return 0;
+    if (mode == CRAFT_EXTRACT_MODE_HISTORY && (version == nullptr || *version == '\0'))
+        return 0;
+
+    try
+    {
+        craft_extract::save_options options{};
+        options.version = version != nullptr ? version : "";
+
+        return craft_extract::writers::save(file->result, path, static_cast<craft_extract::output_mode>(mode), options) ? 1 : 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << std::format("[!] Error: Failed to save output file: {}", e.what()) << std::endl;
+        return 0;
+    }
+}
+
+CRAFT_EXTRACT_API void craft_extract_free(craft_extract_file_t* file)
+{
+    delete file;
+}
+
+CRAFT_EXTRACT_API int32_t craft_extract_open(const char* path, const craft_extract_filter_t* filter, craft_extract_reader_t** reader)
+{
+    if (path == nullptr || reader == nullptr)
+        return 0;
+
+    *reader = nullptr;
+
+    try
+    {
+        auto r = std::make_unique<craft_extract_reader_t>();
+        if (!r->reader.open(path, craft_extract::capi::options(filter)))
+            return 0;
+
+        *reader = r.release();
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << std::format("[!] Error: Failed to open input file: {}", e.what()) << std::endl;
+        return 0;
+    }
+}
+
+CRAFT_EXTRACT_API int32_t craft_extract_next(craft_extract_reader_t* reader, craft_extract_recipe_t* recipe)
+{
+    if (reader == nullptr || recipe == nullptr || !reader->reader.next(reader->craft))
+        return 0;
+
+    craft_extract::capi::convert(reader->reader.strings(), reader->craft, *recipe);
+    return 1;
+}
+
+CRAFT_EXTRACT_API void craft_extract_close(craft_extract_reader_t* reader)
+{
+    delete reader;
+}
+
+} // extern "C"
@@ -0,0 +1,197 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_H
+#define CRAFT_EXTRACT_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+/**
+ * craft_extract C API
+ *
+ * A stable C interface over the craft file parser and writers, exported by the libcraft_extract library:
+ *
+ *      craft_extract_file_t* file = NULL;
+ *      if (craft_extract_parse("tdl.crf", NULL, &file))
+ *      {
+ *          craft_extract_recipe_t recipe;
+ *          for (size_t x = 0; craft_extract_recipe(file, x, &recipe); x++)
+ *              printf("%.*s\n", (int)recipe.name.size, recipe.name.data);
+ *
+ *          craft_extract_write(file, "crafts.csv", CRAFT_EXTRACT_MODE_CSV, NULL);
+ *          craft_extract_free(file);
+ *      }
+ *
+ * Functions returning int32_t return 1 on success and 0 otherwise. Strings are not null terminated; they are views
+ * owned by the file or reader that produced them and remain valid until it is freed or closed. Handles may be used
+ * from any thread, but not from several threads at once.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(CRAFT_EXTRACT_SHARED)
+#if defined(CRAFT_EXTRACT_EXPORTS)
+#define CRAFT_EXTRACT_API __declspec(dllexport)
+#else
+#define CRAFT_EXTRACT_API __declspec(dllimport)
+#endif
+#elif defined(CRAFT_EXTRACT_SHARED)
+#define CRAFT_EXTRACT_API __attribute__((visibility("default")))
+#else
+#define CRAFT_EXTRACT_API
+#endif
+
+/**
+ * The maximum number of materials of a recipe.
+ */
+#define CRAFT_EXTRACT_MAX_MATERIALS 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Output File Format Mode Definitions (See craft_extract::output_mode.)
+ */
+enum
+{
+    CRAFT_EXTRACT_MODE_CSV               = 1,
+    CRAFT_EXTRACT_MODE_JSON              = 2,
+    CRAFT_EXTRACT_MODE_SQLITE            = 3,
+    CRAFT_EXTRACT_MODE_TEXT              = 4,
+    CRAFT_EXTRACT_MODE_SQLITE_NORMALIZED = 5,
+    CRAFT_EXTRACT_MODE_HISTORY           = 6,
+    CRAFT_EXTRACT_MODE_SNAPSHOT          = 7,
+};
+
+/**
+ * Opaque Handle Definitions
+ */
+typedef struct craft_extract_file_t craft_extract_file_t;     // A fully parsed craft file..
+typedef struct craft_extract_reader_t craft_extract_reader_t; // A craft file being read lazily, one recipe at a time..
+
+/**
+ * String View Structure Definition
+ */
+typedef struct craft_extract_string_t
+{
+    const char* data;
+    size_t size;
+} craft_extract_string_t;
+
+/**
+ * Filter Structure Definition (See craft_extract::parse_options; initialize with craft_extract_filter_init.)
+ */
+typedef struct craft_extract_filter_t
+{
+    int32_t realm;          // Restricts parsing to a single realm. (-1 for all realms.)
+    const char* profession; // Restricts parsing to a single profession, by exact name. (NULL for all professions.)
+    const char* category;   // Restricts parsing to a single category, by exact name. (NULL for all categories.)
+    const char* material;   // Restricts parsing to recipes using the given material, by exact name. (NULL for all recipes.)
+    uint32_t min_skill;
+    uint32_t max_skill;
+    uint32_t min_level;
+    uint32_t max_level;
+} craft_extract_filter_t;
+
+/**
+ * Recipe Structure Definitions
+ */
+typedef struct craft_extract_material_t
+{
+    uint32_t base_material;
+    uint32_t count;
+    craft_extract_string_t name;
+} craft_extract_material_t;
+
+typedef struct craft_extract_recipe_t
+{
+    uint32_t realm;
+    uint32_t id;
+    craft_extract_string_t realm_name;
+    craft_extract_string_t profession;
+    craft_extract_string_t category;
+    craft_extract_string_t name;
+    uint32_t base_material;
+    uint32_t icon;
+    uint32_t level;
+    uint32_t material_level;
+    uint32_t skill;
+    uint32_t material_count;
+    craft_extract_material_t materials[CRAFT_EXTRACT_MAX_MATERIALS];
+} craft_extract_recipe_t;
+
+/**
+ * Returns the library version. (ie. 1.0.0.0)
+ */
+CRAFT_EXTRACT_API const char* craft_extract_version(void);
+
+/**
+ * Initializes the given filter to match every recipe.
+ */
+CRAFT_EXTRACT_API void craft_extract_filter_init(craft_extract_filter_t* filter);
+
+/**
+ * Parses the given craft file. (filter may be NULL.) The file must be freed with craft_extract_free.
+ */
+CRAFT_EXTRACT_API int32_t craft_extract_parse(const char* path, const craft_extract_filter_t* filter, craft_extract_file_t** file);
+
+/**
+ * Returns the number of recipes of a parsed craft file.
+ */
+CRAFT_EXTRACT_API size_t craft_extract_count(const craft_extract_file_t* file);
+
+/**
+ * Obtains the recipe at the given index of a parsed craft file. (Recipes are ordered by realm, in file order.)
+ */
+CRAFT_EXTRACT_API int32_t craft_extract_recipe(const craft_extract_file_t* file, size_t index, craft_extract_recipe_t* recipe);
+
+/**
+ * Saves a parsed craft file to the given output file in the given mode. (version is required in history mode only; snapshot mode requires an unfiltered parse.)
+ */
+CRAFT_EXTRACT_API int32_t craft_extract_write(const craft_extract_file_t* file, const char* path, int32_t mode, const char* version);
+
+/**
+ * Frees a parsed craft file.
+ */
+CRAFT_EXTRACT_API void craft_extract_free(craft_extract_file_t* file);
+
+/**
+ * Opens the given craft file for lazy reading. (filter may be NULL.) The reader must be closed with craft_extract_close.
+ */
+CRAFT_EXTRACT_API int32_t craft_extract_open(const char* path, const craft_extract_filter_t* filter, craft_extract_reader_t** reader);
+
+/**
+ * Reads the next recipe of a reader; returns 0 once every recipe has been read.
+ */
+CRAFT_EXTRACT_API int32_t craft_extract_next(craft_extract_reader_t* reader, craft_extract_recipe_t* recipe);
+
+/**
+ * Closes a reader.
+ */
+CRAFT_EXTRACT_API void craft_extract_close(craft_extract_reader_t* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRAFT_EXTRACT_H
@@ -0,0 +1,127 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_CRAFT_QUEUE_HPP
+#define CRAFT_EXTRACT_CRAFT_QUEUE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Craft Recipe Batch Structure Definition
+     */
+    struct craftbatch_t
+    {
+        uint32_t realm;
+        std::vector<craft_extract::craft_t> crafts;
+    };
+
+    /**
+     * Bounded, blocking queue of craft recipe batches.
+     *
+     * Hands recipes from the parser to a writer running on another thread. Producers block while the queue is full
+     * and consumers block while it is empty; closing the queue releases both sides. Once closed, pushes are refused
+     * and pops drain the remaining batches.
+     */
+    class craft_queue
+    {
+        std::mutex mutex_;
+        std::condition_variable readable_;
+        std::condition_variable writable_;
+        std::deque<craft_extract::craftbatch_t> batches_;
+        std::size_t capacity_;
+        bool closed_;
+
+    public:
+        explicit craft_queue(const std::size_t capacity = 4)
+            : capacity_(std::max<std::size_t>(1, capacity))
+            , closed_(false)
+        {}
+
+        craft_queue(const craft_queue&)            = delete;
+        craft_queue& operator=(const craft_queue&) = delete;
+
+        /**
+         * Pushes a batch of craft recipes into the queue, waiting for room if the queue is full.
+         *
+         * @param {uint32_t} realm - The realm index of the recipes.
+         * @param {std::vector<craft_t>} crafts - The craft recipes.
+         * @return {bool} True on success, false if the queue was closed.
+         */
+        bool push(const uint32_t realm, std::vector<craft_extract::craft_t>&& crafts)
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->writable_.wait(lock, [this]() { return this->closed_ || this->batches_.size() < this->capacity_; });
+
+            if (this->closed_)
+                return false;
+
+            this->batches_.push_back({realm, std::move(crafts)});
+            lock.unlock();
+
+            this->readable_.notify_one();
+            return true;
+        }
+
+        /**
+         * Pops the next batch of craft recipes from the queue, waiting for one if the queue is empty.
+         *
+         * @param {craftbatch_t} batch - The batch to store the popped recipes into.
+         * @return {bool} True on success, false if the queue was closed and has been drained.
+         */
+        bool pop(craft_extract::craftbatch_t& batch)
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->readable_.wait(lock, [this]() { return this->closed_ || !this->batches_.empty(); });
+
+            if (this->batches_.empty())
+                return false;
+
+            batch = std::move(this->batches_.front());
+            this->batches_.pop_front();
+            lock.unlock();
+
+            this->writable_.notify_one();
+            return true;
+        }
+
+        /**
+         * Closes the queue, releasing any waiting producers and consumers.
+         */
+        void close(void)
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->closed_ = true;
+            }
+
+            this->readable_.notify_all();
+            this->writable_.notify_all();
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_CRAFT_QUEUE_HPP
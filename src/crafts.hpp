@@ -0,0 +1,163 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_CRAFTS_HPP
+#define CRAFT_EXTRACT_CRAFTS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "hash.hpp"
+#include "inline_vector.hpp"
+#include "string_table.hpp"
+
+namespace craft_extract
+{
+    /**
+     * List of base material names.
+     */
+    const std::vector<std::string> base_materials{
+        /**/ "", "cloth", "leather", "wood", "metal", "organic", "paper", "bronze", "iron", "mithril",
+        /**/ "asterite", "glass", "stone", "laen", "alloy", "steel", "soft", "rawhide", "tanned", "cured",
+        /**/ "hard", "rigid", "embossed", "imbued", "runed", "eldritch", "fine alloy", "", "", "adamantium",
+        /**/ "birch", "rowan", "elm", "oaken", "ironwood", "heartwood", "runewood", "stonewood", "ebonwood", "dyrwood",
+        /**/ "homespun", "woolen", "linen", "brocade", "silk", "gossamer", "sylvan", "seamist", "nightshade", "wyvernskin",
+        /**/ "leaf", "bone", "vine", "shell", "fossil", "amber", "coral", "chitin", "copper", "ferrite",
+        /**/ "quartz", "dolomite", "cobalt", "carbide", "sapphire", "diamond", "netherite", "arcanite", "netherium", "arcanium",
+        /**/ "tempered", "duskwood", "silksteel", "petrified", "crystalized", "emerald", "sapphire", "ruby", "diamond", "aurulite",
+        /**/ "raw", "uncut", "rough", "flawed", "imperfect", "polished", "faceted", "precious", "flawless", "perfect",
+        /**/ "", "", "", "", "", "", "", "", "", "",
+        /**/ "", "rough clout", "rough", "clout", "rough flight", "standard", "footed clout", "flight", "footed", "footed flight",
+        /**/ "keen footed flight", "blunt footed flight", "barbed footed flight", "", "", "", "", "", "", ""};
+
+    /**
+     * List of realm names.
+     */
+    const std::vector<std::string> realm_names{"Albion", "Midgard", "Hibernia"};
+
+    /**
+     * Returns the name of the given base material.
+     *
+     * @param {uint32_t} id - The base material id.
+     * @return {std::string_view} The base material name, empty if the material has no name.
+     */
+    inline std::string_view base_material_name(const uint32_t id)
+    {
+        return id < base_materials.size() ? std::string_view(base_materials[id]) : std::string_view();
+    }
+
+    /**
+     * Parsed Crafting Recipe Structure Definitions
+     */
+
+    struct craftmaterial_t
+    {
+        uint16_t base_material;
+        uint16_t count;
+        uint32_t name_index;
+    };
+
+    struct craft_t
+    {
+        uint32_t name_index_realm;
+        uint32_t name_index_profession;
+        uint32_t name_index_category;
+        uint32_t name_index_recipe;
+
+        uint32_t base_material;
+        uint16_t icon;
+        uint32_t id;
+        uint16_t level;
+        uint16_t material_level;
+        uint16_t skill;
+
+        craft_extract::inline_vector<craft_extract::craftmaterial_t, 8> materials;
+    };
+
+    static_assert(std::is_trivially_copyable_v<craft_extract::craft_t>, "craft_t must remain trivially copyable.");
+
+    /**
+     * The number of recipes handed to a recipe sink at a time.
+     */
+    constexpr std::size_t craft_batch_size = 4096;
+
+    /**
+     * Parsed craft file information.
+     *
+     * Owns everything produced by a single parse; results are independent of each other and may be shared
+     * between threads for reading once parsing has completed.
+     */
+    struct parse_result
+    {
+        craft_extract::string_table strings;
+        std::map<uint32_t, std::vector<craft_extract::craft_t>> crafts;
+        craft_extract::byte_span source; // View over the mapped input file the information was parsed from..
+        uint32_t version = 0;            // The header version of the parsed file..
+        bool filtered    = false;        // Set when filters excluded part of the craft information..
+
+        /**
+         * Clears the parsed information.
+         */
+        void clear(void)
+        {
+            this->strings.clear();
+            this->crafts.clear();
+            this->source   = {};
+            this->version  = 0;
+            this->filtered = false;
+        }
+    };
+
+    /**
+     * Returns the fingerprint of the given craft recipe.
+     *
+     * The fingerprint covers every field of the recipe and its materials, using the string values rather than their
+     * indices, so equal recipes from different files share the same fingerprint.
+     *
+     * @param {parse_result} result - The parsed craft information owning the recipe.
+     * @param {craft_t} craft - The craft recipe to fingerprint.
+     * @return {uint64_t} The recipe fingerprint.
+     */
+    inline uint64_t fingerprint(const craft_extract::parse_result& result, const craft_extract::craft_t& craft)
+    {
+        craft_extract::hasher h;
+
+        h.update(craft.name_index_realm)
+            .update(result.strings[craft.name_index_profession])
+            .update(result.strings[craft.name_index_category])
+            .update(result.strings[craft.name_index_recipe])
+            .update(craft.base_material)
+            .update(craft.icon)
+            .update(craft.id)
+            .update(craft.level)
+            .update(craft.material_level)
+            .update(craft.skill)
+            .update(craft.materials.size());
+
+        for (const auto& m : craft.materials)
+            h.update(m.base_material).update(m.count).update(result.strings[m.name_index]);
+
+        return h.digest();
+    }
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_CRAFTS_HPP
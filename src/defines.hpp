@@ -24,22 +24,56 @@
 #pragma once
 #endif
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <format>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
 namespace craft_extract
 {
+    /**
+     * Tool version; recorded in extraction caches. (Keep in sync with res/resources.rc.)
+     */
+    constexpr auto tool_version = "1.0.0.0";
+
     /**
      * Output File Format Mode Enumeration
      */
@@ -50,13 +84,53 @@ namespace craft_extract
         json   = 2,
         sqlite = 3,
         text   = 4,
+
+        sqlite_normalized = 5,
+        history           = 6,
+        snapshot          = 7,
     };
 
     /**
-     * Parser Function Forwards
+     * Result Forwards
+     */
+    struct craft_t;
+
+    /**
+     * Recipe Sink Function Forwards
+     */
+    using craft_sink_f = std::function<bool(uint32_t, std::vector<craft_extract::craft_t>&&)>;
+
+    /**
+     * Parser Options Structure Definition
      */
-    using parse_f = std::function<bool(FILE*, const std::size_t)>;
-    using save_f  = std::function<bool(const std::string& output, craft_extract::output_mode)>;
+    struct parse_options
+    {
+        bool parallel_realms = false; // Processes each realm on its own thread. (Slower than a sequential parse for typical file sizes; see parse_benchmark.)
+
+        int32_t realm = -1;     // Restricts parsing to a single realm. (-1 for all realms.)
+        std::string profession; // Restricts parsing to a single profession, by exact name. (Empty for all professions.)
+        std::string category;   // Restricts parsing to a single category, by exact name. (Empty for all categories.)
+        std::string material;   // Restricts parsing to recipes using the given material, by exact name. (Empty for all recipes.)
+
+        uint32_t min_skill = 0;          // Restricts parsing to recipes of at least the given skill..
+        uint32_t max_skill = 0xFFFFFFFF; // Restricts parsing to recipes of at most the given skill..
+        uint32_t min_level = 0;          // Restricts parsing to recipes of at least the given level..
+        uint32_t max_level = 0xFFFFFFFF; // Restricts parsing to recipes of at most the given level..
+
+        craft_extract::craft_sink_f sink; // Receives the recipes in batches, in realm order, instead of the result. (Stops parsing when it returns false.)
+    };
+
+    /**
+     * Save Options Structure Definition
+     */
+    struct save_options
+    {
+        std::string version; // The version key the information is stored under. (History mode only.)
+
+        bool cache            = false; // Skips inputs unchanged since their last extraction, tracked by a sidecar cache file..
+        bool parallel_writers = true;  // Writes each output file of an input file on its own thread..
+        bool pipeline         = false; // Writes the recipes while the input file is still being parsed. (Streamable modes only.)
+    };
 
 } // namespace craft_extract
 
@@ -0,0 +1,309 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_DIFF_HPP
+#define CRAFT_EXTRACT_DIFF_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "loader.hpp"
+
+namespace craft_extract::diff
+{
+    /**
+     * Diff Structure Definitions
+     */
+
+    constexpr auto npos = static_cast<std::size_t>(-1);
+
+    struct entry_t
+    {
+        uint64_t fingerprint;
+        const craft_extract::craft_t* craft;
+        std::size_t next; // The next entry sharing the same key. (npos if none.)
+    };
+
+    struct group_t
+    {
+        uint64_t key; // The realm id (high 32 bits) and recipe id (low 32 bits).
+        std::size_t first;
+        std::size_t last;
+        std::size_t count;
+    };
+
+    struct index_t
+    {
+        std::vector<craft_extract::diff::entry_t> entries;
+        std::vector<craft_extract::diff::group_t> groups; // In order of first appearance..
+        std::unordered_map<uint64_t, std::size_t> lookup; // Maps each key to its group..
+
+        /**
+         * Returns if the given group holds an entry with the given fingerprint.
+         *
+         * @param {group_t} group - The group to search.
+         * @param {uint64_t} fingerprint - The fingerprint to find.
+         * @return {bool} True if found, false otherwise.
+         */
+        bool contains(const craft_extract::diff::group_t& group, const uint64_t fingerprint) const
+        {
+            for (auto e = group.first; e != craft_extract::diff::npos; e = this->entries[e].next)
+            {
+                if (this->entries[e].fingerprint == fingerprint)
+                    return true;
+            }
+
+            return false;
+        }
+    };
+
+    struct summary_t
+    {
+        std::size_t added;
+        std::size_t removed;
+        std::size_t changed;
+        std::size_t unchanged;
+    };
+
+    /**
+     * Builds the fingerprint index of the given parsed craft information.
+     *
+     * Entries are grouped by their key, in file order; recipes listed more than once with identical information are
+     * only indexed once.
+     *
+     * @param {parse_result} result - The parsed craft information to index.
+     * @param {index_t} index - The index to populate.
+     */
+    inline void index(const craft_extract::parse_result& result, craft_extract::diff::index_t& index)
+    {
+        index.entries.clear();
+        index.groups.clear();
+        index.lookup.clear();
+
+        std::size_t total = 0;
+        for (const auto& r : result.crafts)
+            total += r.second.size();
+
+        index.entries.reserve(total);
+        index.groups.reserve(total);
+        index.lookup.reserve(total);
+
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& c : r.second)
+            {
+                const auto key         = (static_cast<uint64_t>(r.first) << 32) | c.id;
+                const auto fingerprint = craft_extract::fingerprint(result, c);
+
+                const auto [iter, inserted] = index.lookup.try_emplace(key, index.groups.size());
+                if (inserted)
+                {
+                    index.groups.push_back({key, index.entries.size(), index.entries.size(), 1});
+                    index.entries.push_back({fingerprint, &c, craft_extract::diff::npos});
+                    continue;
+                }
+
+                auto& group = index.groups[iter->second];
+                if (index.contains(group, fingerprint))
+                    continue;
+
+                index.entries[group.last].next = index.entries.size();
+                group.last                     = index.entries.size();
+                group.count++;
+                index.entries.push_back({fingerprint, &c, craft_extract::diff::npos});
+            }
+        }
+    }
+
+    /**
+     * Returns a single line description of the given craft recipe.
+     *
+     * @param {parse_result} result - The parsed craft information owning the recipe.
+     * @param {craft_t} craft - The craft recipe to describe.
+     * @return {std::string} The recipe description.
+     */
+    inline std::string describe(const craft_extract::parse_result& result, const craft_extract::craft_t& craft)
+    {
+        std::string str = std::format("{} - {} - ", result.strings[craft.name_index_profession], result.strings[craft.name_index_category]);
+
+        if (const auto bmaterial = craft_extract::base_material_name(craft.base_material); bmaterial.size() > 0)
+            str += std::format("{} ", bmaterial);
+
+        str += std::format("{} (MLv. {}) [Level: {}][Icon: {}][Skill: {}]",
+            result.strings[craft.name_index_recipe],
+            craft.material_level,
+            craft.level,
+            craft.icon,
+            craft.skill);
+
+        for (auto x = 0u; x < craft.materials.size(); x++)
+        {
+            const auto& m = craft.materials[x];
+
+            str += std::format("{} {}x ", x == 0 ? " :" : ",", m.count);
+            if (const auto bmaterial = craft_extract::base_material_name(m.base_material); bmaterial.size() > 0)
+                str += std::format("{} ", bmaterial);
+            str += result.strings[m.name_index];
+        }
+
+        return str;
+    }
+
+    /**
+     * Compares two parsed craft files and writes the differences to a plain-text report.
+     *
+     * Recipes are matched by their realm and recipe id and compared by their fingerprints; both files are indexed
+     * once into hash tables and each index is then walked once, so the comparison is linear in the number of
+     * recipes. Differences are reported in the order of the new file, followed by the removed recipes in the order
+     * of the old file. Recipe information is compared by value, so files of different versions can be compared.
+     *
+     * @param {parse_result} lhs - The parsed craft information of the old file.
+     * @param {parse_result} rhs - The parsed craft information of the new file.
+     * @param {std::string} path - The output file to save the report to.
+     * @param {summary_t} summary - The summary of the differences.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool compare(const craft_extract::parse_result& lhs, const craft_extract::parse_result& rhs, const std::string& path, craft_extract::diff::summary_t& summary)
+    {
+        summary = {};
+
+        craft_extract::diff::index_t olds;
+        craft_extract::diff::index_t news;
+        craft_extract::diff::index(lhs, olds);
+        craft_extract::diff::index(rhs, news);
+
+        std::ostringstream report;
+
+        // Lists the entries of a group that are missing from the other side..
+        const auto list = [&report](const char* prefix, const craft_extract::parse_result& result, const craft_extract::diff::index_t& index, const craft_extract::diff::group_t& group, const craft_extract::diff::index_t* other, const craft_extract::diff::group_t* other_group) {
+            for (auto e = group.first; e != craft_extract::diff::npos; e = index.entries[e].next)
+            {
+                if (other == nullptr || !other->contains(*other_group, index.entries[e].fingerprint))
+                    report << prefix << craft_extract::diff::describe(result, *index.entries[e].craft) << std::endl;
+            }
+        };
+
+        const auto heading = [&report](const char* kind, const uint64_t key) {
+            report << std::format("{}: {} - Id: {}", kind, realm_names[static_cast<uint32_t>(key >> 32)], static_cast<uint32_t>(key)) << std::endl;
+        };
+
+        // Walk the new index, matching each group against the old index..
+        std::vector<bool> matched(olds.groups.size(), false);
+
+        for (const auto& group : news.groups)
+        {
+            const auto iter = olds.lookup.find(group.key);
+            if (iter == olds.lookup.end())
+            {
+                summary.added++;
+                heading("ADDED", group.key);
+                list("    + ", rhs, news, group, nullptr, nullptr);
+                report << std::endl;
+                continue;
+            }
+
+            matched[iter->second] = true;
+
+            // Both groups hold distinct fingerprints; they are equal when they are the same size and one contains the other..
+            const auto& old_group = olds.groups[iter->second];
+
+            auto same = group.count == old_group.count;
+            for (auto e = group.first; same && e != craft_extract::diff::npos; e = news.entries[e].next)
+                same = olds.contains(old_group, news.entries[e].fingerprint);
+
+            if (same)
+            {
+                summary.unchanged++;
+                continue;
+            }
+
+            summary.changed++;
+            heading("CHANGED", group.key);
+            list("    - ", lhs, olds, old_group, &news, &group);
+            list("    + ", rhs, news, group, &olds, &old_group);
+            report << std::endl;
+        }
+
+        // Report the groups only present in the old index..
+        for (auto x = 0u; x < olds.groups.size(); x++)
+        {
+            if (matched[x])
+                continue;
+
+            summary.removed++;
+            heading("REMOVED", olds.groups[x].key);
+            list("    - ", lhs, olds, olds.groups[x], nullptr, nullptr);
+            report << std::endl;
+        }
+
+        // Open the output file for writing..
+        std::ofstream ofs(path);
+        if (!ofs.is_open())
+        {
+            std::cout << "[!] Failed to open output file for writing!" << std::endl;
+            return false;
+        }
+
+        ofs << "//" << std::endl
+            << "// File generated using craft_exporter by atom0s." << std::endl
+            << "//" << std::endl
+            << std::format("// Added    : {}", summary.added) << std::endl
+            << std::format("// Removed  : {}", summary.removed) << std::endl
+            << std::format("// Changed  : {}", summary.changed) << std::endl
+            << std::format("// Unchanged: {}", summary.unchanged) << std::endl
+            << "//" << std::endl
+            << std::endl
+            << report.str();
+
+        ofs.close();
+
+        return !ofs.fail();
+    }
+
+    /**
+     * Compares the craft information of two input files and saves the differences into the given output file.
+     *
+     * @param {std::string} old_input - The old input file to compare.
+     * @param {std::string} new_input - The new input file to compare.
+     * @param {std::string} output - The output file to save the report to.
+     * @param {parse_options} options - The parsing options.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool run(const std::string& old_input, const std::string& new_input, const std::string& output, const craft_extract::parse_options& options)
+    {
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+
+        if (!craft_extract::load(old_input, options, lhs) || !craft_extract::load(new_input, options, rhs))
+            return false;
+
+        craft_extract::diff::summary_t summary{};
+        if (!craft_extract::diff::compare(lhs, rhs, output, summary))
+            return false;
+
+        std::cout << std::format("[!] Compared: {} added, {} removed, {} changed, {} unchanged.", summary.added, summary.removed, summary.changed, summary.unchanged) << std::endl;
+        return true;
+    }
+
+} // namespace craft_extract::diff
+
+#endif // CRAFT_EXTRACT_DIFF_HPP
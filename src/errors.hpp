@@ -0,0 +1,93 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_ERRORS_HPP
+#define CRAFT_EXTRACT_ERRORS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+namespace craft_extract
+{
+    /**
+     * The error capture of the current thread, if any. (See error_capture.)
+     */
+    inline thread_local std::string* captured_error = nullptr;
+
+    /**
+     * Reports an error of the parser.
+     *
+     * Errors are printed to the console, unless an error capture is active on the current thread; the message is
+     * then stored into the capture instead. (The first error of a capture is kept.)
+     *
+     * @param {std::string_view} message - The error message.
+     */
+    inline void error(const std::string_view message)
+    {
+        if (craft_extract::captured_error == nullptr)
+        {
+            std::cout << "[!] Error: " << message << std::endl;
+            return;
+        }
+
+        if (craft_extract::captured_error->empty())
+            craft_extract::captured_error->assign(message);
+    }
+
+    /**
+     * Captures the errors reported on the current thread for as long as it is alive.
+     *
+     * Used where the console is not available to report errors; ie. inside the SQLite extension.
+     */
+    class error_capture
+    {
+        std::string message_;
+        std::string* previous_;
+
+    public:
+        error_capture(void)
+            : previous_(craft_extract::captured_error)
+        {
+            craft_extract::captured_error = &this->message_;
+        }
+        ~error_capture(void)
+        {
+            craft_extract::captured_error = this->previous_;
+        }
+
+        error_capture(const error_capture&)            = delete;
+        error_capture& operator=(const error_capture&) = delete;
+
+        /**
+         * Returns the first captured error message.
+         *
+         * @return {std::string} The error message, empty if no error was reported.
+         */
+        const std::string& message(void) const
+        {
+            return this->message_;
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_ERRORS_HPP
@@ -0,0 +1,232 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_EXTRACT_HPP
+#define CRAFT_EXTRACT_EXTRACT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "cache.hpp"
+#include "loader.hpp"
+#include "writers.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Extraction Result Enumeration
+     */
+    enum class extract_result : int32_t
+    {
+        failed    = 0,
+        extracted = 1,
+        unchanged = 2,
+    };
+
+    /**
+     * Extraction Target Structure Definition
+     */
+    struct target_t
+    {
+        craft_extract::output_mode mode;
+        std::string output;
+    };
+
+    /**
+     * Returns the given output file with a trailing output mode extension removed.
+     *
+     * Only the extensions of the output modes are removed; any other periods are kept as part of the name.
+     * (ie. 'crafts.csv' becomes 'crafts', while 'export-1.127e' is returned as given.)
+     *
+     * @param {std::string} output - The output file.
+     * @return {std::string} The base path of the output file.
+     */
+    inline std::string base_path(const std::string& output)
+    {
+        std::string_view longest;
+
+        for (auto m = static_cast<int32_t>(craft_extract::output_mode::csv); m <= static_cast<int32_t>(craft_extract::output_mode::snapshot); m++)
+        {
+            const std::string_view ext = craft_extract::writers::extension(static_cast<craft_extract::output_mode>(m));
+            if (ext.size() > longest.size() && output.size() > ext.size() && output.ends_with(ext))
+                longest = ext;
+        }
+
+        return output.substr(0, output.size() - longest.size());
+    }
+
+    /**
+     * Returns the extraction targets of the given base path and modes; each mode is saved to the base path followed
+     * by the extension of the mode.
+     *
+     * @param {std::string} base - The base path of the output files.
+     * @param {std::vector<output_mode>} modes - The output file formats to save.
+     * @return {std::vector<target_t>} The extraction targets.
+     */
+    inline std::vector<craft_extract::target_t> mode_targets(const std::string& base, const std::vector<craft_extract::output_mode>& modes)
+    {
+        std::vector<craft_extract::target_t> targets;
+        targets.reserve(modes.size());
+
+        for (const auto mode : modes)
+            targets.push_back({mode, base + craft_extract::writers::extension(mode)});
+
+        return targets;
+    }
+
+    /**
+     * Returns the extraction targets of the given output file and modes.
+     *
+     * A single mode is saved to the output file as given; when several modes are requested, the output file is
+     * used as the base path of each, with a trailing output mode extension removed, followed by the extension of
+     * each mode.
+     *
+     * @param {std::string} output - The output file.
+     * @param {std::vector<output_mode>} modes - The output file formats to save.
+     * @return {std::vector<target_t>} The extraction targets.
+     */
+    inline std::vector<craft_extract::target_t> targets(const std::string& output, const std::vector<craft_extract::output_mode>& modes)
+    {
+        if (modes.size() == 1)
+            return {{modes.front(), output}};
+
+        return craft_extract::mode_targets(craft_extract::base_path(output), modes);
+    }
+
+    /**
+     * Extracts the craft information of the given input file into the given output files.
+     *
+     * The input file is parsed once and each output file is then written from the same result; when parallel
+     * writers are enabled, the output files are written concurrently. When caching is enabled, output files whose
+     * sidecar cache files match the input file, output mode, tool version and options are skipped, and the input
+     * file is not parsed at all when every output file is up to date. When pipelining is enabled and a single
+     * streamable output file is written, the recipes are handed to the writer in batches while parsing continues.
+     *
+     * @param {std::string} input - The input file to extract craft information from.
+     * @param {std::vector<target_t>} targets - The output files to save the extracted craft information to.
+     * @param {parse_options} options - The parsing options.
+     * @param {save_options} settings - The saving options.
+     * @return {extract_result} The result of the extraction.
+     */
+    inline craft_extract::extract_result extract(const std::string& input, const std::vector<craft_extract::target_t>& targets, const craft_extract::parse_options& options, const craft_extract::save_options& settings)
+    {
+        uint64_t hash = 0;
+        const auto hashed = settings.cache && craft_extract::cache::hash_file(input, hash);
+
+        // Determine which targets need to be written..
+        std::vector<std::pair<const craft_extract::target_t*, std::string>> pending;
+        pending.reserve(targets.size());
+
+        for (const auto& target : targets)
+        {
+            auto key = hashed ? craft_extract::cache::key(hash, target.mode, options, settings) : std::string();
+            if (hashed && craft_extract::cache::fresh(target.output, key))
+                continue;
+
+            // Invalidate the cache before writing; a failed or uncached extraction must not leave a valid cache behind..
+            craft_extract::cache::invalidate(target.output);
+            pending.emplace_back(&target, std::move(key));
+        }
+
+        if (pending.empty())
+            return craft_extract::extract_result::unchanged;
+
+        // Pipeline a single streamable target; the recipes are written while the input file is still being parsed..
+        if (settings.pipeline && pending.size() == 1 && craft_extract::writers::streamable(pending[0].first->mode))
+        {
+            const auto& job = pending[0];
+
+            craft_extract::parse_result result;
+            craft_extract::craft_queue queue;
+
+            auto streaming = options;
+            streaming.sink = [&queue](const uint32_t realm, std::vector<craft_extract::craft_t>&& crafts) {
+                return queue.push(realm, std::move(crafts));
+            };
+
+            auto saved = false;
+            std::thread writer([&]() {
+                saved = craft_extract::writers::stream(result.strings, queue, job.first->output, job.first->mode);
+
+                // Release the parser if the writer stopped early..
+                queue.close();
+            });
+
+            const auto loaded = craft_extract::load(input, streaming, result);
+            queue.close();
+            writer.join();
+
+            if (!loaded || !saved)
+            {
+                // Discard the partially written output file..
+                std::error_code ec;
+                std::filesystem::remove(job.first->output, ec);
+                return craft_extract::extract_result::failed;
+            }
+
+            if (!job.second.empty() && !craft_extract::cache::store(job.first->output, job.second))
+                craft_extract::cache::invalidate(job.first->output);
+
+            return craft_extract::extract_result::extracted;
+        }
+
+        craft_extract::parse_result result;
+        if (!craft_extract::load(input, options, result))
+            return craft_extract::extract_result::failed;
+
+        // Write the targets; the result is only read from here on and is shared by all writers..
+        std::atomic<std::size_t> failed{0};
+
+        const auto write = [&](const std::pair<const craft_extract::target_t*, std::string>& job) {
+            if (!craft_extract::writers::save(result, job.first->output, job.first->mode, settings))
+            {
+                failed++;
+                return;
+            }
+
+            if (!job.second.empty() && !craft_extract::cache::store(job.first->output, job.second))
+                craft_extract::cache::invalidate(job.first->output);
+        };
+
+        if (settings.parallel_writers && pending.size() > 1)
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(pending.size() - 1);
+            for (auto x = 1u; x < pending.size(); x++)
+                threads.emplace_back(write, std::cref(pending[x]));
+
+            write(pending[0]);
+
+            for (auto& t : threads)
+                t.join();
+        }
+        else
+        {
+            for (const auto& job : pending)
+                write(job);
+        }
+
+        return failed == 0 ? craft_extract::extract_result::extracted : craft_extract::extract_result::failed;
+    }
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_EXTRACT_HPP
@@ -0,0 +1,172 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_FILTERS_HPP
+#define CRAFT_EXTRACT_FILTERS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "string_table.hpp"
+
+namespace craft_extract::filters
+{
+    /**
+     * Returns if the given string table entry equals the given filter value. (An empty filter matches everything.)
+     *
+     * @param {string_table} strings - The craft file string table.
+     * @param {uint32_t} name_index - The string table index of the name to match.
+     * @param {std::string} filter - The filter value.
+     * @return {bool} True if the name matches, false otherwise.
+     */
+    inline bool name(const craft_extract::string_table& strings, const uint32_t name_index, const std::string& filter)
+    {
+        return filter.empty() || (name_index < strings.size() && strings[name_index] == filter);
+    }
+
+    /**
+     * Returns if any filter of the given parsing options is set.
+     *
+     * @param {parse_options} options - The parsing options.
+     * @return {bool} True if part of the craft information can be excluded, false otherwise.
+     */
+    inline bool active(const craft_extract::parse_options& options)
+    {
+        const craft_extract::parse_options defaults{};
+
+        return options.realm != defaults.realm ||
+               !options.profession.empty() ||
+               !options.category.empty() ||
+               !options.material.empty() ||
+               options.min_skill != defaults.min_skill ||
+               options.max_skill != defaults.max_skill ||
+               options.min_level != defaults.min_level ||
+               options.max_level != defaults.max_level;
+    }
+
+    /**
+     * Returns if the given realm passes the realm filter.
+     *
+     * @param {parse_options} options - The parsing options.
+     * @param {uint32_t} realm - The realm index.
+     * @return {bool} True if the realm is wanted, false otherwise.
+     */
+    inline bool realm(const craft_extract::parse_options& options, const uint32_t realm)
+    {
+        return options.realm == -1 || options.realm == static_cast<int32_t>(realm);
+    }
+
+    /**
+     * Returns if the given recipe passes the skill, level and material filters.
+     *
+     * Checked against the recipe record in place, before a craft recipe entry is produced for it.
+     *
+     * @param {parse_options} options - The parsing options.
+     * @param {string_table} strings - The craft file string table.
+     * @param {Recipe} recipe - The recipe record.
+     * @return {bool} True if the recipe is wanted, false otherwise.
+     */
+    template<typename Recipe>
+    bool recipe(const craft_extract::parse_options& options, const craft_extract::string_table& strings, const Recipe& recipe)
+    {
+        if (recipe.skill < options.min_skill || recipe.skill > options.max_skill)
+            return false;
+        if (recipe.level < options.min_level || recipe.level > options.max_level)
+            return false;
+
+        if (options.material.empty())
+            return true;
+
+        return std::ranges::any_of(recipe.materials, [&](const auto& m) -> bool {
+            return m.count != 0 && craft_extract::filters::name(strings, m.name_index, options.material);
+        });
+    }
+
+    /**
+     * Parses a realm filter value; either a realm index or a realm name. (Case-insensitive.)
+     *
+     * @param {std::string_view} value - The value to parse.
+     * @param {int32_t} realm - The realm index to store the result into.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool parse_realm(const std::string_view value, int32_t& realm)
+    {
+        for (auto x = 0u; x < craft_extract::realm_names.size(); x++)
+        {
+            const auto& name = craft_extract::realm_names[x];
+            if (std::ranges::equal(value, name, [](const char a, const char b) { return std::tolower(static_cast<uint8_t>(a)) == std::tolower(static_cast<uint8_t>(b)); }))
+            {
+                realm = static_cast<int32_t>(x);
+                return true;
+            }
+        }
+
+        int32_t index = -1;
+        const auto res = std::from_chars(value.data(), value.data() + value.size(), index);
+        if (res.ec != std::errc() || res.ptr != value.data() + value.size() || index < 0 || index >= static_cast<int32_t>(craft_extract::realm_names.size()))
+            return false;
+
+        realm = index;
+        return true;
+    }
+
+    /**
+     * Parses a range filter value. (ie. 500-700, 500- or -700; a single value matches only itself.)
+     *
+     * @param {std::string_view} value - The value to parse.
+     * @param {uint32_t} min - The lower bound to store the result into. (Left unchanged when open.)
+     * @param {uint32_t} max - The upper bound to store the result into. (Left unchanged when open.)
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool parse_range(const std::string_view value, uint32_t& min, uint32_t& max)
+    {
+        const auto number = [](const std::string_view str, uint32_t& out) -> bool {
+            const auto res = std::from_chars(str.data(), str.data() + str.size(), out);
+            return res.ec == std::errc() && res.ptr == str.data() + str.size();
+        };
+
+        const auto dash = value.find('-');
+        if (dash == std::string_view::npos)
+        {
+            if (!number(value, min))
+                return false;
+
+            max = min;
+            return true;
+        }
+
+        const auto lo = value.substr(0, dash);
+        const auto hi = value.substr(dash + 1);
+
+        if (lo.empty() && hi.empty())
+            return false;
+        if (!lo.empty() && !number(lo, min))
+            return false;
+        if (!hi.empty() && !number(hi, max))
+            return false;
+
+        return min <= max;
+    }
+
+} // namespace craft_extract::filters
+
+#endif // CRAFT_EXTRACT_FILTERS_HPP
@@ -0,0 +1,159 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_HASH_HPP
+#define CRAFT_EXTRACT_HASH_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Incremental 64-bit FNV-1a hasher.
+     *
+     * Used to fingerprint recipes; not suitable for anything security related. Recipe fingerprints are stored in
+     * history databases, so the algorithm must not change.
+     */
+    class hasher
+    {
+        uint64_t value_;
+
+    public:
+        hasher(void)
+            : value_(0xCBF29CE484222325ull)
+        {}
+
+        /**
+         * Mixes the given block of bytes into the hash.
+         *
+         * @param {void*} data - The data to hash.
+         * @param {std::size_t} size - The size of the data, in bytes.
+         * @return {hasher} Reference to this hasher.
+         */
+        craft_extract::hasher& update(const void* data, const std::size_t size)
+        {
+            const auto bytes = static_cast<const uint8_t*>(data);
+
+            for (std::size_t x = 0; x < size; x++)
+            {
+                this->value_ ^= bytes[x];
+                this->value_ *= 0x100000001B3ull;
+            }
+
+            return *this;
+        }
+
+        /**
+         * Mixes the given string into the hash, including its length.
+         *
+         * @param {std::string_view} str - The string to hash.
+         * @return {hasher} Reference to this hasher.
+         */
+        craft_extract::hasher& update(const std::string_view str)
+        {
+            this->update(static_cast<uint64_t>(str.size()));
+            return this->update(str.data(), str.size());
+        }
+
+        /**
+         * Mixes the given integral value into the hash.
+         *
+         * @param {T} value - The value to hash.
+         * @return {hasher} Reference to this hasher.
+         */
+        template<typename T>
+            requires std::is_integral_v<T>
+        craft_extract::hasher& update(const T value)
+        {
+            return this->update(&value, sizeof(T));
+        }
+
+        /**
+         * Returns the current hash value.
+         *
+         * @return {uint64_t} The hash value.
+         */
+        uint64_t digest(void) const
+        {
+            return this->value_;
+        }
+    };
+
+    /**
+     * Computes the 64-bit content hash of the given block of bytes.
+     *
+     * Consumes eight bytes per step, so large input files are hashed at memory speed rather than byte by byte. Used
+     * to detect changed input files; not suitable for anything security related.
+     *
+     * @param {void*} data - The data to hash.
+     * @param {std::size_t} size - The size of the data, in bytes.
+     * @return {uint64_t} The hash value.
+     */
+    inline uint64_t content_hash(const void* data, const std::size_t size)
+    {
+        constexpr uint64_t k0 = 0x9E3779B97F4A7C15ull;
+        constexpr uint64_t k1 = 0xBF58476D1CE4E5B9ull;
+        constexpr uint64_t k2 = 0x94D049BB133111EBull;
+
+        const auto mix = [](uint64_t word) -> uint64_t {
+            word *= k1;
+            word = std::rotl(word, 31);
+            return word * k2;
+        };
+
+        const auto bytes = static_cast<const uint8_t*>(data);
+        auto value       = static_cast<uint64_t>(size) * k0;
+
+        std::size_t x = 0;
+        for (; x + 8 <= size; x += 8)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + x, 8);
+
+            value ^= mix(word);
+            value = std::rotl(value, 27) * k0 + 0x52DCE729ull;
+        }
+
+        // Mix in the remaining bytes..
+        if (x < size)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + x, size - x);
+
+            value ^= mix(word);
+            value = std::rotl(value, 27) * k0 + 0x52DCE729ull;
+        }
+
+        // Finalize the hash, spreading every input bit over the result..
+        value ^= value >> 30;
+        value *= k1;
+        value ^= value >> 27;
+        value *= k2;
+        value ^= value >> 31;
+
+        return value;
+    }
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_HASH_HPP
@@ -0,0 +1,112 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_INLINE_VECTOR_HPP
+#define CRAFT_EXTRACT_INLINE_VECTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Fixed-capacity vector with inline storage.
+     *
+     * Holds up to N elements without any heap allocations; when T is trivially copyable, so is the vector.
+     */
+    template<typename T, std::size_t N>
+    class inline_vector
+    {
+        std::array<T, N> items_{};
+        std::size_t count_{0};
+
+    public:
+        using value_type     = T;
+        using iterator       = T*;
+        using const_iterator = const T*;
+
+        /**
+         * Appends an element to the end of the vector.
+         *
+         * @param {T} item - The element to append.
+         * @return {bool} True on success, false if the vector is full.
+         */
+        bool push_back(const T& item)
+        {
+            if (this->count_ == N)
+                return false;
+
+            this->items_[this->count_++] = item;
+            return true;
+        }
+
+        /**
+         * Removes all elements from the vector.
+         */
+        void clear(void)
+        {
+            this->count_ = 0;
+        }
+
+        std::size_t size(void) const
+        {
+            return this->count_;
+        }
+        static constexpr std::size_t capacity(void)
+        {
+            return N;
+        }
+        bool empty(void) const
+        {
+            return this->count_ == 0;
+        }
+
+        T& operator[](const std::size_t index)
+        {
+            return this->items_[index];
+        }
+        const T& operator[](const std::size_t index) const
+        {
+            return this->items_[index];
+        }
+
+        iterator begin(void)
+        {
+            return this->items_.data();
+        }
+        iterator end(void)
+        {
+            return this->items_.data() + this->count_;
+        }
+        const_iterator begin(void) const
+        {
+            return this->items_.data();
+        }
+        const_iterator end(void) const
+        {
+            return this->items_.data() + this->count_;
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_INLINE_VECTOR_HPP
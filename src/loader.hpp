@@ -0,0 +1,142 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_LOADER_HPP
+#define CRAFT_EXTRACT_LOADER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "errors.hpp"
+#include "mapped_file.hpp"
+#include "parser.hpp"
+#include "v66.hpp"
+#include "v67.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Compile-time list of file layouts.
+     *
+     * Header versions are routed to the parser instantiated for their layout without any lookup table or type
+     * erasure; each supported version is a single comparison against a constant.
+     */
+    template<typename... Layouts>
+    struct layout_list
+    {
+        /**
+         * Lazy traversal cursor of any of the listed layouts.
+         */
+        using cursor_t = std::variant<std::monostate, craft_extract::parser::cursor_t<Layouts>...>;
+
+        /**
+         * Invokes the given function with the layout of the given header version.
+         *
+         * @param {uint32_t} version - The header version.
+         * @param {Fn} fn - The function to invoke; called with a std::type_identity of the layout.
+         * @return {bool} The result of the function, false if the header version is not supported.
+         */
+        template<typename Fn>
+        static bool dispatch(const uint32_t version, Fn&& fn)
+        {
+            auto result = false;
+
+            if (!((version == Layouts::version && (result = fn(std::type_identity<Layouts>{}), true)) || ...))
+                craft_extract::error(std::format("Unsupported header version: {:08X}", version));
+
+            return result;
+        }
+    };
+
+    /**
+     * Supported file layouts.
+     */
+    using layouts = craft_extract::layout_list<
+        craft_extract::parser::v66::layout_t, // v1.86 to v1.124b
+        craft_extract::parser::v67::layout_t  // v1.127e
+        >;
+
+    /**
+     * Maps the given input file for reading and obtains its header version.
+     *
+     * @param {std::string} path - The input file to map.
+     * @param {std::shared_ptr<mapped_file>} file - The mapped input file.
+     * @param {uint32_t} version - The header version of the input file.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool map(const std::string& path, std::shared_ptr<craft_extract::mapped_file>& file, uint32_t& version)
+    {
+        // Ensure the input file exists..
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec))
+        {
+            craft_extract::error("Invalid input file given.");
+            return false;
+        }
+
+        // Map the input file for reading..
+        file = std::make_shared<craft_extract::mapped_file>();
+        if (!file->open(path))
+        {
+            craft_extract::error("Failed to open input file for reading.");
+            return false;
+        }
+
+        // Obtain and validate the file size..
+        const auto data = file->span();
+
+        if (data.size() < 4)
+        {
+            craft_extract::error("Input file too small; cannot parse.");
+            return false;
+        }
+
+        // Read the header version..
+        version = *data.at<uint32_t>(0);
+        return true;
+    }
+
+    /**
+     * Loads and parses the craft information of the given input file.
+     *
+     * @param {std::string} path - The input file to parse.
+     * @param {parse_options} options - The parsing options.
+     * @param {parse_result} result - The result to store the parsed information into.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool load(const std::string& path, const craft_extract::parse_options& options, craft_extract::parse_result& result)
+    {
+        std::shared_ptr<craft_extract::mapped_file> file;
+        uint32_t version = 0;
+
+        if (!craft_extract::map(path, file, version))
+            return false;
+
+        // Parse the file with the layout of its header version..
+        return craft_extract::layouts::dispatch(version, [&]<typename Layout>(std::type_identity<Layout>) {
+            return craft_extract::parser::parse<Layout>(file->span(), options, result);
+        });
+    }
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_LOADER_HPP
@@ -18,8 +18,10 @@
  */
 
 #include "defines.hpp"
-#include "v66.hpp"
-#include "v67.hpp"
+#include "batch.hpp"
+#include "diff.hpp"
+#include "extract.hpp"
+#include "filters.hpp"
 
 #include "cxxopts.hpp"
 
@@ -30,47 +32,75 @@
  * @param {char*[]} argv - The argument array.
  * @return {int32_t} 0 on success, 1 on general error, 2 on exception.
  */
-int32_t __cdecl main(int32_t argc, char* argv[])
+int32_t main(int32_t argc, char* argv[])
 {
-    ::printf_s("Dark Age of Camelot Craft Information Extractor.\n");
-    ::printf_s("(c) 2022 atom0s [atom0s@live.com]\n\n");
-    ::printf_s("Contact  : https://atom0s.com/\n");
-    ::printf_s("Contact  : https://twitter.com/atom0s\n");
-    ::printf_s("Contact  : https://discord.gg/UmXNvjq - atom0s#0001\n");
-    ::printf_s("Donations: https://www.paypal.me/atom0s\n");
-    ::printf_s("Donations: https://github.com/sponsors/atom0s\n");
-    ::printf_s("Donations: https://patreon.com/atom0s\n\n");
-
-    // Prepare supported parsers map..
-    std::map<int32_t, std::tuple<craft_extract::parse_f, craft_extract::save_f>> parsers = {
-        // v1.86 to v1.124b
-        {0x66, std::make_tuple<craft_extract::parse_f, craft_extract::save_f>(craft_extract::parser::v66::parse, craft_extract::parser::v66::save)},
-
-        // v1.127e
-        {0x67, std::make_tuple<craft_extract::parse_f, craft_extract::save_f>(craft_extract::parser::v67::parse, craft_extract::parser::v67::save)},
-    };
+    std::printf("Dark Age of Camelot Craft Information Extractor.\n");
+    std::printf("(c) 2022 atom0s [atom0s@live.com]\n\n");
+    std::printf("Contact  : https://atom0s.com/\n");
+    std::printf("Contact  : https://twitter.com/atom0s\n");
+    std::printf("Contact  : https://discord.gg/UmXNvjq - atom0s#0001\n");
+    std::printf("Donations: https://www.paypal.me/atom0s\n");
+    std::printf("Donations: https://github.com/sponsors/atom0s\n");
+    std::printf("Donations: https://patreon.com/atom0s\n\n");
 
     try
     {
         std::string path_input;
         std::string path_output;
-        auto mode  = craft_extract::output_mode::none;
-        auto mode_ = 0;
+        std::string path_batch;
+        std::string path_diff;
+        std::string version;
+        std::string realm;
+        std::string skill;
+        std::string level;
+        std::vector<craft_extract::output_mode> modes;
+        std::vector<int32_t> modes_;
+        auto jobs     = 0u;
+        auto cache    = false;
+        auto pipeline = false;
+
+        craft_extract::parse_options filters{};
 
         cxxopts::Options options("craft_extract", "Extracts binary serialized craft information for DAoC.");
         options.custom_help("[options...]");
         options.add_options()
             /**/ ("f,file", "The input file to extract craft information from. (ie. tdl.crf)", cxxopts::value<std::string>(path_input))
             /**/ ("o,out", "The output file to save the extracted craft information to.", cxxopts::value<std::string>(path_output))
-            /**/ ("m,mode", "The output file saving mode.", cxxopts::value<int32_t>(mode_)->default_value("0"));
+            /**/ ("m,mode", "The output file saving mode(s). (ie. 1 or 1,2,4; with several modes, --out is used as the base path of each output file.)", cxxopts::value<std::vector<int32_t>>(modes_)->default_value("0"))
+            /**/ ("b,batch", "A directory, wildcard pattern or manifest file of input files to extract. (--out is used as the output directory.)", cxxopts::value<std::string>(path_batch))
+            /**/ ("j,jobs", "The number of files to extract in parallel in batch mode. (0 uses one per hardware thread.)", cxxopts::value<uint32_t>(jobs)->default_value("0"))
+            /**/ ("d,diff", "A newer input file to compare --file against. (The differences are saved to --out as a plain-text report.)", cxxopts::value<std::string>(path_diff))
+            /**/ ("c,cache", "Skips input files unchanged since their last extraction. (Tracked in a sidecar .cache file next to each output file.)", cxxopts::value<bool>(cache))
+            /**/ ("p,pipeline", "Writes the recipes while the input file is still being parsed. (csv, sqlite and sqlnorm modes; a single mode only.)", cxxopts::value<bool>(pipeline))
+            /**/ ("k,key", "The version key to store the extracted information under in history mode. (ie. 1.127e)", cxxopts::value<std::string>(version));
+        options.add_options("Filter")
+            /**/ ("realm", "Only extracts the recipes of the given realm. (ie. 0, 1, 2, Albion, Midgard or Hibernia)", cxxopts::value<std::string>(realm))
+            /**/ ("profession", "Only extracts the recipes of the given profession, by exact name. (ie. Weaponcraft)", cxxopts::value<std::string>(filters.profession))
+            /**/ ("category", "Only extracts the recipes of the given category, by exact name.", cxxopts::value<std::string>(filters.category))
+            /**/ ("skill", "Only extracts the recipes within the given skill range. (ie. 500-700, 500- or -700)", cxxopts::value<std::string>(skill))
+            /**/ ("level", "Only extracts the recipes within the given level range. (ie. 40-51, 40- or -51)", cxxopts::value<std::string>(level))
+            /**/ ("material", "Only extracts the recipes using the given material, by exact name.", cxxopts::value<std::string>(filters.material));
 
         options.parse(argc, argv);
 
-        // Obtain the mode value..
-        mode = static_cast<craft_extract::output_mode>(mode_);
+        // Obtain the mode values..
+        for (const auto m : modes_)
+        {
+            if (m <= 0 || m > static_cast<int32_t>(craft_extract::output_mode::snapshot))
+            {
+                modes.clear();
+                break;
+            }
+
+            // Ignore repeated modes..
+            if (std::ranges::find(modes, static_cast<craft_extract::output_mode>(m)) == modes.end())
+                modes.push_back(static_cast<craft_extract::output_mode>(m));
+        }
+
+        const auto history = std::ranges::find(modes, craft_extract::output_mode::history) != modes.end();
 
         // Check for valid arguments..
-        if (argc <= 1 || path_input.size() == 0 || path_output.size() == 0 || mode == craft_extract::output_mode::none)
+        if (argc <= 1 || (path_input.size() == 0 && path_batch.size() == 0) || path_output.size() == 0 || (modes.empty() && path_diff.size() == 0) || (history && version.size() == 0))
         {
             std::cout << options.help() << std::endl;
             std::cout << "Modes:" << std::endl
@@ -78,59 +108,88 @@ int32_t __cdecl main(int32_t argc, char* argv[])
                       << "  1 - csv     - Information saved into a comma-separated value file." << std::endl
                       << "  2 - json    - Information saved into a JSON formatted file." << std::endl
                       << "  3 - sqlite  - Information saved into an SQLite database file." << std::endl
-                      << "  4 - text    - Information saved into a plain-text file." << std::endl;
+                      << "  4 - text    - Information saved into a plain-text file." << std::endl
+                      << "  5 - sqlnorm - Information saved into a normalized SQLite database file. (Names stored once, referenced by id.)" << std::endl
+                      << "  6 - history - Information appended into an SQLite history database under the --key version. (Rows shared between versions stored once.)" << std::endl
+                      << "  7 - crfx    - Information saved into a memory-mappable binary snapshot file. (Tied to the input file it was made from.)" << std::endl;
 
             return 1;
         }
 
-        // Ensure the input file exists..
-        if (::GetFileAttributesA(path_input.c_str()) == INVALID_FILE_ATTRIBUTES)
+        // Obtain the filter values..
+        if (realm.size() > 0 && !craft_extract::filters::parse_realm(realm, filters.realm))
         {
-            std::cout << "[!] Error: Invalid input file given." << std::endl;
+            std::cout << "[!] Error: Invalid realm filter given; expected 0, 1, 2, Albion, Midgard or Hibernia." << std::endl;
             return 1;
         }
-
-        // Open the input file for reading..
-        FILE* f = nullptr;
-        if (::fopen_s(&f, path_input.c_str(), "rb") != ERROR_SUCCESS)
+        if (skill.size() > 0 && !craft_extract::filters::parse_range(skill, filters.min_skill, filters.max_skill))
         {
-            std::cout << "[!] Error: Failed to open input file for reading." << std::endl;
+            std::cout << "[!] Error: Invalid skill filter given; expected a range. (ie. 500-700, 500- or -700)" << std::endl;
             return 1;
         }
-
-        // Obtain and validate the file size..
-        ::fseek(f, 0, SEEK_END);
-        const auto size = ::_ftelli64(f);
-        ::fseek(f, 0, SEEK_SET);
-
-        if (size < 4)
+        if (level.size() > 0 && !craft_extract::filters::parse_range(level, filters.min_level, filters.max_level))
         {
-            ::fclose(f);
-            std::cout << "[!] Error: Input file too small; cannot parse." << std::endl;
+            std::cout << "[!] Error: Invalid level filter given; expected a range. (ie. 40-51, 40- or -51)" << std::endl;
             return 1;
         }
 
-        // Read and validate the header version..
-        uint32_t version = 0;
-        ::fread(&version, sizeof(version), 1, f);
-        ::fseek(f, 0, SEEK_SET);
+        // Compare the input files..
+        if (path_diff.size() > 0)
+        {
+            if (!craft_extract::diff::run(path_input, path_diff, path_output, filters))
+                return 1;
+
+            std::cout << "[!] Done!" << std::endl;
+            return 0;
+        }
 
-        if (!parsers.contains(version))
+        // Obtain the saving options..
+        craft_extract::save_options settings{};
+        settings.version  = version;
+        settings.cache    = cache;
+        settings.pipeline = pipeline;
+
+        // Ensure no two modes write to the same output file..
+        const auto targets = craft_extract::targets(path_output, modes);
+        for (auto x = 1u; x < targets.size(); x++)
         {
-            ::fclose(f);
-            std::cout << std::format("[!] Error: Unsupported header version: {:08X}", version) << std::endl;
-            return 1;
+            for (auto y = 0u; y < x; y++)
+            {
+                if (targets[x].output == targets[y].output)
+                {
+                    std::cout << std::format("[!] Error: Multiple modes would be saved to the same output file: {}", targets[x].output) << std::endl;
+                    return 1;
+                }
+            }
         }
 
-        // Parse and save the read data..
-        if (!(std::get<0>(parsers[version])(f, size)) ||
-            !(std::get<1>(parsers[version])(path_output, mode)))
+        // Extract the batch of input files..
+        if (path_batch.size() > 0)
         {
-            ::fclose(f);
-            return 1;
+            std::vector<craft_extract::batch::job_t> batch;
+            if (!craft_extract::batch::collect(path_batch, path_output, modes, batch))
+                return 1;
+
+            std::cout << std::format("[!] Extracting {} file(s)..", batch.size()) << std::endl;
+
+            const auto failed = craft_extract::batch::run(batch, jobs, filters, settings);
+            if (failed > 0)
+            {
+                std::cout << std::format("[!] Error: Failed to extract {} of {} file(s).", failed, batch.size()) << std::endl;
+                return 1;
+            }
+
+            std::cout << "[!] Done!" << std::endl;
+            return 0;
         }
 
-        ::fclose(f);
+        // Extract the input file..
+        const auto result = craft_extract::extract(path_input, targets, filters, settings);
+        if (result == craft_extract::extract_result::failed)
+            return 1;
+        if (result == craft_extract::extract_result::unchanged)
+            std::cout << "[!] Input file unchanged since the last extraction; skipped. (Run without --cache to extract anyway.)" << std::endl;
+
         std::cout << "[!] Done!" << std::endl;
         return 0;
     }
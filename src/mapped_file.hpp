@@ -0,0 +1,231 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_MAPPED_FILE_HPP
+#define CRAFT_EXTRACT_MAPPED_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "platform.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Read-only, bounds-checked view over a block of bytes.
+     *
+     * Structures are handed out as pointers directly into the viewed memory; nothing is copied. The span
+     * optionally carries a handle to the owner of the memory, which can be retained to keep it alive.
+     */
+    class byte_span
+    {
+        std::shared_ptr<const void> owner_;
+        const uint8_t* data_;
+        std::size_t size_;
+
+    public:
+        byte_span(void)
+            : data_(nullptr)
+            , size_(0)
+        {}
+        byte_span(std::shared_ptr<const void> owner, const uint8_t* data, const std::size_t size)
+            : owner_(std::move(owner))
+            , data_(data)
+            , size_(size)
+        {}
+
+        /**
+         * Returns the handle to the owner of the viewed memory.
+         *
+         * @return {std::shared_ptr<const void>} The owner handle, or nullptr if the memory is not shared-owned.
+         */
+        const std::shared_ptr<const void>& owner(void) const
+        {
+            return this->owner_;
+        }
+
+        /**
+         * Returns the start of the viewed memory.
+         *
+         * @return {const uint8_t*} The start of the viewed memory.
+         */
+        const uint8_t* data(void) const
+        {
+            return this->data_;
+        }
+
+        /**
+         * Returns the size of the viewed memory.
+         *
+         * @return {std::size_t} The size of the viewed memory, in bytes.
+         */
+        std::size_t size(void) const
+        {
+            return this->size_;
+        }
+
+        /**
+         * Returns if the given range lies entirely within the viewed memory.
+         *
+         * @param {std::size_t} offset - The offset of the range.
+         * @param {std::size_t} length - The length of the range, in bytes.
+         * @return {bool} True if the range is within bounds, false otherwise.
+         */
+        bool contains(const std::size_t offset, const std::size_t length) const
+        {
+            return offset <= this->size_ && length <= this->size_ - offset;
+        }
+
+        /**
+         * Returns if the given array of objects lies entirely within the viewed memory.
+         *
+         * @param {std::size_t} offset - The offset of the array.
+         * @param {std::size_t} count - The number of objects in the array.
+         * @return {bool} True if the array is within bounds, false otherwise.
+         */
+        template<typename T>
+        bool contains_array(const std::size_t offset, const std::size_t count) const
+        {
+            return offset <= this->size_ && count <= (this->size_ - offset) / sizeof(T);
+        }
+
+        /**
+         * Returns a pointer to an object stored at the given offset.
+         *
+         * @param {std::size_t} offset - The offset of the object.
+         * @return {const T*} Pointer to the object on success, nullptr if out of bounds.
+         */
+        template<typename T>
+        const T* at(const std::size_t offset) const
+        {
+            if (!this->contains(offset, sizeof(T)))
+                return nullptr;
+
+            return reinterpret_cast<const T*>(this->data_ + offset);
+        }
+
+        /**
+         * Returns a span of objects stored at the given offset.
+         *
+         * @param {std::size_t} offset - The offset of the array.
+         * @param {std::size_t} count - The number of objects in the array.
+         * @return {std::span<const T>} The array on success, an empty span if out of bounds.
+         */
+        template<typename T>
+        std::span<const T> array(const std::size_t offset, const std::size_t count) const
+        {
+            if (!this->contains_array<T>(offset, count))
+                return {};
+
+            return std::span<const T>(reinterpret_cast<const T*>(this->data_ + offset), count);
+        }
+    };
+
+    /**
+     * Read-only memory mapping of an input file.
+     *
+     * The mapping is kept alive for as long as the object exists. When the object is owned by a std::shared_ptr,
+     * spans obtained from it hold a reference to it and may be retained past the owners lifetime.
+     */
+    class mapped_file : public std::enable_shared_from_this<mapped_file>
+    {
+        craft_extract::platform::handle_t file_;
+        void* mapping_;
+        const uint8_t* view_;
+        std::size_t size_;
+
+    public:
+        mapped_file(void)
+            : file_(craft_extract::platform::invalid_handle)
+            , mapping_(nullptr)
+            , view_(nullptr)
+            , size_(0)
+        {}
+        ~mapped_file(void)
+        {
+            this->close();
+        }
+
+        mapped_file(const mapped_file&)            = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        /**
+         * Opens and maps the given file for reading.
+         *
+         * @param {std::string} path - The path to the file to map.
+         * @return {bool} True on success, false otherwise.
+         */
+        bool open(const std::string& path)
+        {
+            this->close();
+
+            this->file_ = craft_extract::platform::open(path);
+            if (this->file_ == craft_extract::platform::invalid_handle)
+                return false;
+
+            if (!craft_extract::platform::size(this->file_, this->size_))
+            {
+                this->close();
+                return false;
+            }
+
+            // Empty files cannot be mapped; treat them as a valid, empty view..
+            if (this->size_ == 0)
+                return true;
+
+            this->view_ = craft_extract::platform::map(this->file_, this->size_, this->mapping_);
+            if (this->view_ == nullptr)
+            {
+                this->close();
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Unmaps and closes the current file.
+         */
+        void close(void)
+        {
+            craft_extract::platform::unmap(this->view_, this->size_, this->mapping_);
+            craft_extract::platform::close(this->file_);
+
+            this->file_    = craft_extract::platform::invalid_handle;
+            this->mapping_ = nullptr;
+            this->view_    = nullptr;
+            this->size_    = 0;
+        }
+
+        /**
+         * Returns a view over the whole mapped file.
+         *
+         * @return {byte_span} The view of the mapped file.
+         */
+        craft_extract::byte_span span(void) const
+        {
+            return craft_extract::byte_span(this->weak_from_this().lock(), this->view_, this->size_);
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_MAPPED_FILE_HPP
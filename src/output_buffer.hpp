@@ -0,0 +1,137 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_OUTPUT_BUFFER_HPP
+#define CRAFT_EXTRACT_OUTPUT_BUFFER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Buffered output file writer.
+     *
+     * Output is accumulated into a reusable in-memory buffer and handed to the file in large blocks once the buffer
+     * reaches its threshold, or when the writer is closed. Numbers are formatted in place without allocating.
+     */
+    class output_buffer
+    {
+        std::ofstream stream_;
+        std::string buffer_;
+        std::size_t threshold_;
+
+    public:
+        explicit output_buffer(const std::size_t threshold = 4 * 1024 * 1024)
+            : threshold_(threshold)
+        {}
+
+        /**
+         * Opens the given file for writing.
+         *
+         * @param {std::string} path - The output file to write to.
+         * @return {bool} True on success, false otherwise.
+         */
+        bool open(const std::string& path)
+        {
+            this->stream_.open(path);
+            this->buffer_.clear();
+            this->buffer_.reserve(this->threshold_ + 4096);
+
+            return this->stream_.is_open();
+        }
+
+        /**
+         * Writes any buffered output and closes the file.
+         *
+         * @return {bool} True if all output was written successfully, false otherwise.
+         */
+        bool close(void)
+        {
+            this->drain();
+            this->stream_.close();
+
+            return !this->stream_.fail();
+        }
+
+        /**
+         * Appends a string to the output.
+         *
+         * @param {std::string_view} str - The string to append.
+         */
+        void append(const std::string_view str)
+        {
+            this->buffer_.append(str);
+            this->check();
+        }
+
+        /**
+         * Appends a character to the output.
+         *
+         * @param {char} c - The character to append.
+         */
+        void append(const char c)
+        {
+            this->buffer_.push_back(c);
+            this->check();
+        }
+
+        /**
+         * Appends the decimal representation of a number to the output.
+         *
+         * @param {T} value - The number to append.
+         */
+        template<typename T>
+        void append_number(const T value)
+        {
+            char buffer[32]{};
+            const auto res = std::to_chars(std::begin(buffer), std::end(buffer), value);
+
+            this->buffer_.append(buffer, res.ptr);
+            this->check();
+        }
+
+    private:
+        /**
+         * Writes the buffered output to the file once the buffer has reached its threshold.
+         */
+        void check(void)
+        {
+            if (this->buffer_.size() >= this->threshold_)
+                this->drain();
+        }
+
+        /**
+         * Writes the buffered output to the file.
+         */
+        void drain(void)
+        {
+            if (!this->buffer_.empty())
+                this->stream_.write(this->buffer_.data(), static_cast<std::streamsize>(this->buffer_.size()));
+
+            this->buffer_.clear();
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_OUTPUT_BUFFER_HPP
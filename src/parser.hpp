@@ -0,0 +1,543 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_PARSER_HPP
+#define CRAFT_EXTRACT_PARSER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "errors.hpp"
+#include "filters.hpp"
+#include "mapped_file.hpp"
+
+/**
+ * Craft file parser, shared by every supported file version.
+ *
+ * Each file version describes its on-disk structures with a layout traits structure; the parser is instantiated
+ * once per layout. A layout provides the following:
+ *
+ *      header_t, recipe_t, category_t, profession_t, professions_t - The file structures of the version.
+ *      version         - The file header version.
+ *      first_category  - The first used entry of each professions category index list.
+ *
+ * The structures must provide the fields used below by name; their order and any unknown fields may differ
+ * between versions. See v66.hpp for an example.
+ */
+namespace craft_extract::parser
+{
+    /**
+     * Parsing State Structure Definitions
+     */
+
+    template<typename Layout>
+    struct realmtables_t
+    {
+        const typename Layout::professions_t* professions;
+        std::span<const typename Layout::recipe_t> recipes;
+        std::span<const typename Layout::category_t> categories;
+    };
+
+    template<typename Layout>
+    struct planentry_t
+    {
+        uint32_t name_index_profession;
+        uint32_t name_index_category;
+        const typename Layout::recipe_t* recipe;
+    };
+
+    /**
+     * Returns if every name of the given recipe refers to an entry of the string table.
+     *
+     * Recipes of corrupt files whose recipe or material names are out of range are skipped, as are professions and
+     * categories with out of range names.
+     *
+     * @param {string_table} strings - The craft file string table.
+     * @param {Recipe} recipe - The recipe record.
+     * @return {bool} True if every name is valid, false otherwise.
+     */
+    template<typename Recipe>
+    bool valid_names(const craft_extract::string_table& strings, const Recipe& recipe)
+    {
+        if (recipe.name_index >= strings.size())
+            return false;
+
+        return std::ranges::all_of(recipe.materials, [&](const auto& m) -> bool { return m.count == 0 || m.name_index < strings.size(); });
+    }
+
+    /**
+     * Returns if the given profession is processed; unused, unnamed and filtered professions are skipped.
+     *
+     * Shared by the traversal plan and the lazy cursor so that both skip the same entries.
+     *
+     * @param {uint32_t} p - The profession slot.
+     * @param {profession_t} profession - The profession.
+     * @param {string_table} strings - The craft file string table.
+     * @param {parse_options} options - The parsing options.
+     * @return {bool} True if the profession is processed, false otherwise.
+     */
+    template<typename Layout>
+    bool use_profession(const uint32_t p, const typename Layout::profession_t& profession, const craft_extract::string_table& strings, const craft_extract::parse_options& options)
+    {
+        if (p != 0 && profession.index == 0)
+            return false;
+        if (profession.name_index == 0 || profession.name_index >= strings.size())
+            return false;
+
+        return craft_extract::filters::name(strings, profession.name_index, options.profession);
+    }
+
+    /**
+     * Returns the category of the given category index, if it is processed.
+     *
+     * Out of range, unnamed and filtered categories are skipped before their recipes are read.
+     *
+     * @param {realmtables_t} tables - The craft tables of the realm.
+     * @param {uint32_t} pidx - The category index.
+     * @param {string_table} strings - The craft file string table.
+     * @param {parse_options} options - The parsing options.
+     * @return {category_t*} The category if it is processed, nullptr otherwise.
+     */
+    template<typename Layout>
+    const typename Layout::category_t* use_category(const parser::realmtables_t<Layout>& tables, const uint32_t pidx, const craft_extract::string_table& strings, const craft_extract::parse_options& options)
+    {
+        if (pidx == 0 || pidx >= tables.categories.size())
+            return nullptr;
+
+        const auto& category = tables.categories[pidx];
+        if (category.name_index == 0 || category.name_index >= strings.size())
+            return nullptr;
+        if (!craft_extract::filters::name(strings, category.name_index, options.category))
+            return nullptr;
+
+        return &category;
+    }
+
+    /**
+     * Returns the recipe of the given recipe id, if it is processed.
+     *
+     * Out of range, unnamed, material-less, corrupt and filtered recipes are skipped.
+     *
+     * @param {realmtables_t} tables - The craft tables of the realm.
+     * @param {uint32_t} rid - The recipe id.
+     * @param {string_table} strings - The craft file string table.
+     * @param {parse_options} options - The parsing options.
+     * @return {recipe_t*} The recipe if it is processed, nullptr otherwise.
+     */
+    template<typename Layout>
+    const typename Layout::recipe_t* use_recipe(const parser::realmtables_t<Layout>& tables, const uint32_t rid, const craft_extract::string_table& strings, const craft_extract::parse_options& options)
+    {
+        if (rid == 0 || rid >= tables.recipes.size())
+            return nullptr;
+
+        const auto& recipe = tables.recipes[rid];
+        if (recipe.name_index == 0)
+            return nullptr;
+
+        // Skip recipes that have no materials..
+        if (std::ranges::all_of(recipe.materials, [](const auto& m) -> bool { return m.count == 0; }))
+            return nullptr;
+        if (!parser::valid_names(strings, recipe))
+            return nullptr;
+        if (!craft_extract::filters::recipe(options, strings, recipe))
+            return nullptr;
+
+        return &recipe;
+    }
+
+    /**
+     * Builds the traversal plan of a realm; the list of recipes to be processed, in output order.
+     *
+     * @param {realmtables_t} tables - The craft tables of the realm.
+     * @param {string_table} strings - The craft file string table.
+     * @param {parse_options} options - The parsing options.
+     * @param {std::vector<planentry_t>} plan - The plan to populate.
+     */
+    template<typename Layout>
+    void build_plan(const parser::realmtables_t<Layout>& tables, const craft_extract::string_table& strings, const craft_extract::parse_options& options, std::vector<parser::planentry_t<Layout>>& plan)
+    {
+        plan.clear();
+
+        // Process each profession..
+        for (auto p = 0u; p < std::extent_v<decltype(Layout::professions_t::professions)>; p++)
+        {
+            const auto& profession = tables.professions->professions[p];
+            if (!parser::use_profession<Layout>(p, profession, strings, options))
+                continue;
+
+            // Process each professions list of categories..
+            for (auto i = Layout::first_category; i < std::extent_v<decltype(Layout::profession_t::index_list)>; i++)
+            {
+                const auto category = parser::use_category<Layout>(tables, profession.index_list[i], strings, options);
+                if (category == nullptr)
+                    continue;
+
+                // Process each categories list of recipes..
+                for (const auto rid : category->recipe_ids)
+                {
+                    const auto recipe = parser::use_recipe<Layout>(tables, rid, strings, options);
+                    if (recipe != nullptr)
+                        plan.push_back({profession.name_index, category->name_index, recipe});
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns the craft recipe entry of the given recipe.
+     *
+     * @param {uint32_t} realm - The realm index.
+     * @param {uint32_t} name_index_profession - The profession name index.
+     * @param {uint32_t} name_index_category - The category name index.
+     * @param {recipe_t} recipe - The recipe.
+     * @return {craft_t} The craft recipe entry.
+     */
+    template<typename Layout>
+    craft_extract::craft_t make_craft(const uint32_t realm, const uint32_t name_index_profession, const uint32_t name_index_category, const typename Layout::recipe_t& recipe)
+    {
+        // Prepare the craft recipe entry..
+        craft_extract::craft_t craft{};
+        craft.name_index_realm      = realm;
+        craft.name_index_profession = name_index_profession;
+        craft.name_index_category   = name_index_category;
+        craft.name_index_recipe     = recipe.name_index;
+        craft.base_material         = recipe.base_material;
+        craft.icon                  = recipe.icon;
+        craft.id                    = recipe.id;
+        craft.level                 = recipe.level;
+        craft.material_level        = recipe.material_level;
+        craft.skill                 = recipe.skill;
+
+        // Add the craft recipe materials..
+        for (const auto& mat : recipe.materials)
+        {
+            if (mat.count == 0)
+                continue;
+
+            craft_extract::craftmaterial_t material{};
+            material.base_material = mat.base_material;
+            material.count         = mat.count;
+            material.name_index    = mat.name_index;
+
+            craft.materials.push_back(material);
+        }
+
+        return craft;
+    }
+
+    /**
+     * Processes the traversal plan of a realm, producing its craft recipe entries.
+     *
+     * @param {uint32_t} realm - The realm index.
+     * @param {std::span<planentry_t>} plan - The plan entries to process.
+     * @param {std::vector<craft_t>} out - The container to store the craft recipe entries into.
+     */
+    template<typename Layout>
+    void process_plan(const uint32_t realm, const std::span<const parser::planentry_t<Layout>> plan, std::vector<craft_extract::craft_t>& out)
+    {
+        out.reserve(out.size() + plan.size());
+
+        for (const auto& entry : plan)
+            out.push_back(parser::make_craft<Layout>(realm, entry.name_index_profession, entry.name_index_category, *entry.recipe));
+    }
+
+    /**
+     * Lazy craft recipe traversal cursor.
+     *
+     * Walks the craft tables in the same order as the traversal plan, producing one recipe at a time without
+     * building a plan or storing any recipes. The cursor only refers to the mapped file and string table; both must
+     * outlive it.
+     */
+    template<typename Layout>
+    class cursor_t
+    {
+        std::array<parser::realmtables_t<Layout>, 3> tables_{};
+        const craft_extract::string_table* strings_{nullptr};
+        craft_extract::parse_options options_;
+
+        uint32_t realm_{3};
+        uint32_t next_profession_{0};
+        uint32_t next_index_{0};
+        uint32_t next_slot_{0};
+        const typename Layout::profession_t* profession_{nullptr};
+        const typename Layout::category_t* category_{nullptr};
+
+        bool wanted(const uint32_t realm) const
+        {
+            return craft_extract::filters::realm(this->options_, realm);
+        }
+
+    public:
+        /**
+         * Resets the cursor to the start of the given craft tables.
+         *
+         * @param {std::array<realmtables_t, 3>} tables - The craft tables of each realm.
+         * @param {string_table} strings - The craft file string table.
+         * @param {parse_options} options - The parsing options.
+         */
+        void reset(const std::array<parser::realmtables_t<Layout>, 3>& tables, const craft_extract::string_table& strings, const craft_extract::parse_options& options)
+        {
+            this->tables_  = tables;
+            this->strings_ = &strings;
+            this->options_ = options;
+
+            this->realm_           = 0;
+            this->next_profession_ = 0;
+            this->profession_      = nullptr;
+            this->category_        = nullptr;
+
+            while (this->realm_ < 3 && !this->wanted(this->realm_))
+                this->realm_++;
+        }
+
+        /**
+         * Produces the next craft recipe entry.
+         *
+         * @param {craft_t} craft - The craft recipe entry to store the next recipe into.
+         * @return {bool} True on success, false once every recipe has been produced.
+         */
+        bool next(craft_extract::craft_t& craft)
+        {
+            while (this->realm_ < 3)
+            {
+                const auto& tables = this->tables_[this->realm_];
+
+                // Produce the next recipe of the current category..
+                if (this->category_ != nullptr)
+                {
+                    while (this->next_slot_ < std::extent_v<decltype(Layout::category_t::recipe_ids)>)
+                    {
+                        const auto recipe = parser::use_recipe<Layout>(tables, this->category_->recipe_ids[this->next_slot_++], *this->strings_, this->options_);
+                        if (recipe == nullptr)
+                            continue;
+
+                        craft = parser::make_craft<Layout>(this->realm_, this->profession_->name_index, this->category_->name_index, *recipe);
+                        return true;
+                    }
+
+                    this->category_ = nullptr;
+                }
+
+                // Move to the next category of the current profession..
+                if (this->profession_ != nullptr)
+                {
+                    while (this->category_ == nullptr && this->next_index_ < std::extent_v<decltype(Layout::profession_t::index_list)>)
+                    {
+                        this->category_  = parser::use_category<Layout>(tables, this->profession_->index_list[this->next_index_++], *this->strings_, this->options_);
+                        this->next_slot_ = 0;
+                    }
+
+                    if (this->category_ != nullptr)
+                        continue;
+
+                    this->profession_ = nullptr;
+                }
+
+                // Move to the next profession of the current realm..
+                while (this->profession_ == nullptr && this->next_profession_ < std::extent_v<decltype(Layout::professions_t::professions)>)
+                {
+                    const auto p           = this->next_profession_++;
+                    const auto& profession = tables.professions->professions[p];
+
+                    if (!parser::use_profession<Layout>(p, profession, *this->strings_, this->options_))
+                        continue;
+
+                    this->profession_ = &profession;
+                    this->next_index_ = Layout::first_category;
+                }
+
+                if (this->profession_ != nullptr)
+                    continue;
+
+                // Move to the next realm..
+                do
+                {
+                    this->realm_++;
+                } while (this->realm_ < 3 && !this->wanted(this->realm_));
+
+                this->next_profession_ = 0;
+            }
+
+            return false;
+        }
+    };
+
+    /**
+     * Validates the file header and loads the string table and craft tables of the current file.
+     *
+     * @param {byte_span} data - View over the mapped input file.
+     * @param {string_table} strings - The string table to load.
+     * @param {std::array<realmtables_t, 3>} tables - The craft tables of each realm.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Layout>
+    bool load_tables(const craft_extract::byte_span& data, craft_extract::string_table& strings, std::array<parser::realmtables_t<Layout>, 3>& tables)
+    {
+        // Validate the file size..
+        if (data.size() < sizeof(typename Layout::header_t))
+        {
+            craft_extract::error("Input file too small; cannot fully parse.");
+            return false;
+        }
+
+        // Obtain and validate the file header..
+        const auto& header = *data.at<typename Layout::header_t>(0);
+
+        if (header.version != Layout::version)
+        {
+            craft_extract::error(std::format("Invalid file header version; expected 0x{:02X}, got: {}", Layout::version, header.version));
+            return false;
+        }
+
+        // Parse the strings table..
+        if (!strings.load(data, sizeof(typename Layout::header_t) + header.strings_offset, header.strings_block_size, header.strings_count))
+        {
+            craft_extract::error("Failed to parse string table information.");
+            return false;
+        }
+
+        // Obtain the crafting information for each realm..
+        for (auto realm = 0; realm < 3; realm++)
+        {
+            const auto& rdata = header.realms[realm];
+
+            if (!data.contains(rdata.profession_list_offset, sizeof(typename Layout::professions_t)) ||
+                !data.contains_array<typename Layout::recipe_t>(rdata.recipe_list_offset, rdata.recipe_count) ||
+                !data.contains_array<typename Layout::category_t>(rdata.category_list_offset, rdata.category_count))
+            {
+                craft_extract::error(std::format("Invalid realm table information; cannot parse realm: {}", realm));
+                return false;
+            }
+
+            // Obtain the professions, recipes and categories tables in place..
+            tables[realm].professions = data.at<typename Layout::professions_t>(rdata.profession_list_offset);
+            tables[realm].recipes     = data.array<typename Layout::recipe_t>(rdata.recipe_list_offset, rdata.recipe_count);
+            tables[realm].categories  = data.array<typename Layout::category_t>(rdata.category_list_offset, rdata.category_count);
+        }
+
+        return true;
+    }
+
+    /**
+     * Opens the current file for lazy traversal.
+     *
+     * @param {byte_span} data - View over the mapped input file.
+     * @param {parse_options} options - The parsing options. (Only the filters are used.)
+     * @param {string_table} strings - The string table to load.
+     * @param {cursor_t} cursor - The cursor to reset to the start of the file.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Layout>
+    bool open(const craft_extract::byte_span& data, const craft_extract::parse_options& options, craft_extract::string_table& strings, parser::cursor_t<Layout>& cursor)
+    {
+        std::array<parser::realmtables_t<Layout>, 3> tables{};
+        if (!parser::load_tables<Layout>(data, strings, tables))
+            return false;
+
+        cursor.reset(tables, strings, options);
+        return true;
+    }
+
+    /**
+     * Parses the current file for craft information.
+     *
+     * @param {byte_span} data - View over the mapped input file.
+     * @param {parse_options} options - The parsing options.
+     * @param {parse_result} result - The result to store the parsed information into.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Layout>
+    bool parse(const craft_extract::byte_span& data, const craft_extract::parse_options& options, craft_extract::parse_result& result)
+    {
+        result.clear();
+
+        std::array<parser::realmtables_t<Layout>, 3> tables{};
+        if (!parser::load_tables<Layout>(data, result.strings, tables))
+            return false;
+
+        result.source   = data;
+        result.version  = Layout::version;
+        result.filtered = craft_extract::filters::active(options);
+
+        // Hand the recipes to the sink in batches, in realm order, when one is given..
+        if (options.sink)
+        {
+            for (auto r = 0u; r < tables.size(); r++)
+            {
+                if (!craft_extract::filters::realm(options, r))
+                    continue;
+
+                std::vector<parser::planentry_t<Layout>> plan;
+                parser::build_plan<Layout>(tables[r], result.strings, options, plan);
+
+                for (auto x = 0u; x < plan.size(); x += craft_extract::craft_batch_size)
+                {
+                    std::vector<craft_extract::craft_t> batch;
+                    parser::process_plan<Layout>(r, std::span(plan).subspan(x, std::min(craft_extract::craft_batch_size, plan.size() - x)), batch);
+
+                    if (!options.sink(r, std::move(batch)))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Process recipes for each realm..
+        std::array<std::vector<craft_extract::craft_t>, 3> crafts;
+
+        const auto process_realm = [&](const uint32_t realm) {
+            if (!craft_extract::filters::realm(options, realm))
+                return;
+
+            std::vector<parser::planentry_t<Layout>> plan;
+            parser::build_plan<Layout>(tables[realm], result.strings, options, plan);
+            parser::process_plan<Layout>(realm, plan, crafts[realm]);
+        };
+
+        if (options.parallel_realms)
+        {
+            std::vector<std::thread> threads;
+            for (auto r = 0u; r < tables.size(); r++)
+                threads.emplace_back(process_realm, r);
+            for (auto& t : threads)
+                t.join();
+        }
+        else
+        {
+            for (auto r = 0u; r < tables.size(); r++)
+                process_realm(r);
+        }
+
+        // Store the processed recipes, in realm order..
+        for (auto r = 0u; r < crafts.size(); r++)
+        {
+            if (!crafts[r].empty())
+                result.crafts[r] = std::move(crafts[r]);
+        }
+
+        return true;
+    }
+
+} // namespace craft_extract::parser
+
+#endif // CRAFT_EXTRACT_PARSER_HPP
@@ -0,0 +1,175 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_PLATFORM_HPP
+#define CRAFT_EXTRACT_PLATFORM_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+/**
+ * Platform file I/O layer.
+ *
+ * The thin set of operating system calls the parsers need to read input files; Win32 on Windows, POSIX elsewhere.
+ * Files are opened read-only with a sequential access hint and read through a read-only memory mapping.
+ */
+namespace craft_extract::platform
+{
+#if defined(_WIN32)
+    using handle_t = HANDLE;
+
+    inline const handle_t invalid_handle = INVALID_HANDLE_VALUE;
+#else
+    using handle_t = int;
+
+    constexpr handle_t invalid_handle = -1;
+#endif
+
+    /**
+     * Opens the given file for reading.
+     *
+     * @param {std::string} path - The path to the file to open.
+     * @return {handle_t} The file handle, invalid_handle on failure.
+     */
+    inline craft_extract::platform::handle_t open(const std::string& path)
+    {
+#if defined(_WIN32)
+        return ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+#else
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            return craft_extract::platform::invalid_handle;
+
+        // Hint that the file is read front to back; enables aggressive readahead..
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return fd;
+#endif
+    }
+
+    /**
+     * Closes the given file.
+     *
+     * @param {handle_t} file - The file handle to close.
+     */
+    inline void close(const craft_extract::platform::handle_t file)
+    {
+        if (file == craft_extract::platform::invalid_handle)
+            return;
+
+#if defined(_WIN32)
+        ::CloseHandle(file);
+#else
+        ::close(file);
+#endif
+    }
+
+    /**
+     * Obtains the size of the given file.
+     *
+     * @param {handle_t} file - The file handle.
+     * @param {std::size_t} size - The size of the file, in bytes.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool size(const craft_extract::platform::handle_t file, std::size_t& size)
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER value{};
+        if (!::GetFileSizeEx(file, &value))
+            return false;
+
+        size = static_cast<std::size_t>(value.QuadPart);
+        return true;
+#else
+        struct stat st{};
+        if (::fstat(file, &st) != 0 || !S_ISREG(st.st_mode))
+            return false;
+
+        size = static_cast<std::size_t>(st.st_size);
+        return true;
+#endif
+    }
+
+    /**
+     * Maps the given file into memory for reading.
+     *
+     * @param {handle_t} file - The file handle.
+     * @param {std::size_t} size - The size of the file, in bytes. (Must not be 0.)
+     * @param {void*} mapping - The mapping object backing the view; passed back to unmap. (Windows only.)
+     * @return {const uint8_t*} The mapped view of the file, nullptr on failure.
+     */
+    inline const uint8_t* map(const craft_extract::platform::handle_t file, const std::size_t size, void*& mapping)
+    {
+#if defined(_WIN32)
+        (void)size;
+
+        mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+            return nullptr;
+
+        const auto view = static_cast<const uint8_t*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (view == nullptr)
+        {
+            ::CloseHandle(mapping);
+            mapping = nullptr;
+        }
+
+        return view;
+#else
+        mapping = nullptr;
+
+        const auto view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED)
+            return nullptr;
+
+        // The tables are visited out of file order; fault the whole file in ahead of the parser..
+        ::madvise(view, size, MADV_WILLNEED);
+        return static_cast<const uint8_t*>(view);
+#endif
+    }
+
+    /**
+     * Unmaps a view obtained from map.
+     *
+     * @param {const uint8_t*} view - The mapped view.
+     * @param {std::size_t} size - The size of the mapped view, in bytes.
+     * @param {void*} mapping - The mapping object backing the view.
+     */
+    inline void unmap(const uint8_t* view, const std::size_t size, void* mapping)
+    {
+#if defined(_WIN32)
+        (void)size;
+
+        if (view != nullptr)
+            ::UnmapViewOfFile(view);
+        if (mapping != nullptr)
+            ::CloseHandle(mapping);
+#else
+        (void)mapping;
+
+        if (view != nullptr)
+            ::munmap(const_cast<uint8_t*>(view), size);
+#endif
+    }
+
+} // namespace craft_extract::platform
+
+#endif // CRAFT_EXTRACT_PLATFORM_HPP
@@ -0,0 +1,204 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_RECIPE_READER_HPP
+#define CRAFT_EXTRACT_RECIPE_READER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "loader.hpp"
+#include "mapped_file.hpp"
+#include "parser.hpp"
+#include "string_table.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Lazy craft recipe reader.
+     *
+     * Produces the recipes of a craft file one at a time, straight from the mapped file, in the same order as parse;
+     * no recipes are stored and reading can stop at any point. The reader is a single-pass input range:
+     *
+     *      craft_extract::recipe_reader reader;
+     *      if (reader.open("tdl.crf"))
+     *      {
+     *          for (const auto& craft : reader | std::views::filter([](const auto& c) { return c.skill >= 1000; }) | std::views::take(10))
+     *              std::cout << reader.strings()[craft.name_index_recipe] << std::endl;
+     *      }
+     *
+     * Name indices of the produced recipes refer to the readers string table.
+     */
+    class recipe_reader
+    {
+        std::shared_ptr<craft_extract::mapped_file> file_;
+        craft_extract::string_table strings_;
+        craft_extract::layouts::cursor_t cursor_;
+
+    public:
+        /**
+         * Craft recipe input iterator.
+         */
+        class iterator
+        {
+            craft_extract::recipe_reader* reader_;
+            craft_extract::craft_t craft_;
+            bool done_;
+
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type       = craft_extract::craft_t;
+            using difference_type  = std::ptrdiff_t;
+
+            iterator(void)
+                : reader_(nullptr)
+                , craft_{}
+                , done_(true)
+            {}
+            explicit iterator(craft_extract::recipe_reader* reader)
+                : reader_(reader)
+                , craft_{}
+                , done_(!reader->next(this->craft_))
+            {}
+
+            const craft_extract::craft_t& operator*(void) const
+            {
+                return this->craft_;
+            }
+            const craft_extract::craft_t* operator->(void) const
+            {
+                return &this->craft_;
+            }
+
+            iterator& operator++(void)
+            {
+                this->done_ = !this->reader_->next(this->craft_);
+                return *this;
+            }
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& iter, std::default_sentinel_t)
+            {
+                return iter.done_;
+            }
+        };
+
+        recipe_reader(void) = default;
+
+        recipe_reader(const recipe_reader&)            = delete;
+        recipe_reader& operator=(const recipe_reader&) = delete;
+
+        /**
+         * Opens the given input file for reading.
+         *
+         * @param {std::string} path - The input file to read.
+         * @param {parse_options} options - The parsing options. (Only the filters are used.)
+         * @return {bool} True on success, false otherwise.
+         */
+        bool open(const std::string& path, const craft_extract::parse_options& options = {})
+        {
+            this->close();
+
+            uint32_t version = 0;
+            if (!craft_extract::map(path, this->file_, version))
+            {
+                this->close();
+                return false;
+            }
+
+            const auto data    = this->file_->span();
+            const auto success = craft_extract::layouts::dispatch(version, [&]<typename Layout>(std::type_identity<Layout>) {
+                return craft_extract::parser::open<Layout>(data, options, this->strings_, this->cursor_.template emplace<craft_extract::parser::cursor_t<Layout>>());
+            });
+
+            if (!success)
+                this->close();
+
+            return success;
+        }
+
+        /**
+         * Closes the current input file.
+         */
+        void close(void)
+        {
+            this->cursor_.emplace<std::monostate>();
+            this->strings_.clear();
+            this->file_.reset();
+        }
+
+        /**
+         * Returns the string table of the current input file.
+         *
+         * @return {string_table} The string table.
+         */
+        const craft_extract::string_table& strings(void) const
+        {
+            return this->strings_;
+        }
+
+        /**
+         * Reads the next craft recipe.
+         *
+         * @param {craft_t} craft - The craft recipe entry to store the next recipe into.
+         * @return {bool} True on success, false once every recipe has been read.
+         */
+        bool next(craft_extract::craft_t& craft)
+        {
+            return std::visit([&craft](auto& cursor) -> bool {
+                if constexpr (std::is_same_v<std::decay_t<decltype(cursor)>, std::monostate>)
+                    return false;
+                else
+                    return cursor.next(craft);
+            }, this->cursor_);
+        }
+
+        /**
+         * Returns an iterator over the remaining craft recipes.
+         *
+         * @return {iterator} The iterator.
+         */
+        iterator begin(void)
+        {
+            return iterator(this);
+        }
+
+        /**
+         * Returns the end sentinel of the craft recipes.
+         *
+         * @return {std::default_sentinel_t} The end sentinel.
+         */
+        std::default_sentinel_t end(void) const
+        {
+            return std::default_sentinel;
+        }
+    };
+
+    static_assert(std::input_iterator<craft_extract::recipe_reader::iterator>, "recipe_reader::iterator must be an input iterator.");
+    static_assert(std::ranges::input_range<craft_extract::recipe_reader>, "recipe_reader must be an input range.");
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_RECIPE_READER_HPP
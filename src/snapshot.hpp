@@ -0,0 +1,379 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_SNAPSHOT_HPP
+#define CRAFT_EXTRACT_SNAPSHOT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "cache.hpp"
+#include "crafts.hpp"
+#include "mapped_file.hpp"
+
+/**
+ * Binary craft snapshot (.crfx) format.
+ *
+ * A snapshot holds the parsed craft information of an input file, pre-resolved into flat, offset-addressed
+ * arrays so that it can be memory mapped and used without parsing:
+ *
+ *      header_t                    - Format identification, source file hash and version, section offsets.
+ *      recipe_t[recipe_count]      - The recipes, in realm and output order.
+ *      material_t[material_count]  - The materials of every recipe; each recipe refers to a contiguous range.
+ *      string_t[string_count]      - The offset and size of each string within the string arena.
+ *      char[strings_size]          - The string arena; each string is null terminated.
+ *
+ * String indices are those of the source files string table. All values are little-endian and every section
+ * is 8-byte aligned. Snapshots always hold the complete craft information of their source file; they cannot be
+ * made from filtered parses.
+ */
+namespace craft_extract::snapshot
+{
+    /**
+     * Snapshot Format Definitions
+     */
+
+    constexpr uint32_t magic   = 0x58465243; // 'CRFX'
+    constexpr uint32_t version = 1;          // Increased whenever the layout of the format changes..
+
+    struct header_t
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t source_version;
+        uint32_t reserved;
+        uint64_t source_hash;
+        uint32_t recipe_count;
+        uint32_t material_count;
+        uint32_t string_count;
+        uint32_t strings_size;
+        uint64_t recipes_offset;
+        uint64_t materials_offset;
+        uint64_t string_index_offset;
+        uint64_t strings_offset;
+    };
+
+    struct recipe_t
+    {
+        uint32_t name_index_realm;
+        uint32_t name_index_profession;
+        uint32_t name_index_category;
+        uint32_t name_index_recipe;
+        uint32_t base_material;
+        uint32_t id;
+        uint16_t icon;
+        uint16_t level;
+        uint16_t material_level;
+        uint16_t skill;
+        uint32_t first_material;
+        uint32_t material_count;
+    };
+
+    struct material_t
+    {
+        uint32_t name_index;
+        uint16_t base_material;
+        uint16_t count;
+    };
+
+    struct string_t
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    static_assert(sizeof(snapshot::header_t) == 72, "Invalid header_t size.");
+    static_assert(sizeof(snapshot::recipe_t) == 40, "Invalid recipe_t size.");
+    static_assert(sizeof(snapshot::material_t) == 8, "Invalid material_t size.");
+    static_assert(sizeof(snapshot::string_t) == 8, "Invalid string_t size.");
+
+    // The structures are written and mapped as-is; the format is only little-endian on little-endian hosts..
+    static_assert(std::endian::native == std::endian::little, "Snapshots require a little-endian host.");
+
+    /**
+     * Saves the parsed craft information to a snapshot file.
+     *
+     * The recorded content hash is taken from the same mapping of the source file the information was parsed from.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the snapshot.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save(const craft_extract::parse_result& result, const std::string& path)
+    {
+        // Snapshots are accepted in place of their source file; they must hold all of its craft information..
+        if (result.filtered)
+        {
+            std::cout << "[!] Error: Snapshots cannot be saved from filtered craft information." << std::endl;
+            return false;
+        }
+
+        if (result.source.data() == nullptr)
+        {
+            std::cout << "[!] Error: Snapshots require the source file the craft information was parsed from." << std::endl;
+            return false;
+        }
+
+        std::vector<snapshot::recipe_t> recipes;
+        std::vector<snapshot::material_t> materials;
+        std::vector<snapshot::string_t> strings;
+        std::string arena;
+
+        // Flatten the recipes and their materials..
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+            {
+                snapshot::recipe_t recipe{};
+                recipe.name_index_realm      = craft.name_index_realm;
+                recipe.name_index_profession = craft.name_index_profession;
+                recipe.name_index_category   = craft.name_index_category;
+                recipe.name_index_recipe     = craft.name_index_recipe;
+                recipe.base_material         = craft.base_material;
+                recipe.id                    = craft.id;
+                recipe.icon                  = craft.icon;
+                recipe.level                 = craft.level;
+                recipe.material_level        = craft.material_level;
+                recipe.skill                 = craft.skill;
+                recipe.first_material        = static_cast<uint32_t>(materials.size());
+                recipe.material_count        = static_cast<uint32_t>(craft.materials.size());
+
+                for (const auto& mat : craft.materials)
+                    materials.push_back({mat.name_index, mat.base_material, mat.count});
+
+                recipes.push_back(recipe);
+            }
+        }
+
+        // Build the string arena..
+        strings.reserve(result.strings.size());
+        for (auto x = 0u; x < result.strings.size(); x++)
+        {
+            const auto str = result.strings[x];
+
+            strings.push_back({static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(str.size())});
+            arena.append(str);
+            arena.push_back('\0');
+        }
+
+        const auto align = [](const uint64_t offset) -> uint64_t {
+            return (offset + 7) & ~static_cast<uint64_t>(7);
+        };
+
+        // Prepare the header..
+        snapshot::header_t header{};
+        header.magic               = snapshot::magic;
+        header.version             = snapshot::version;
+        header.source_version      = result.version;
+        header.source_hash         = craft_extract::content_hash(result.source.data(), result.source.size());
+        header.recipe_count        = static_cast<uint32_t>(recipes.size());
+        header.material_count      = static_cast<uint32_t>(materials.size());
+        header.string_count        = static_cast<uint32_t>(strings.size());
+        header.strings_size        = static_cast<uint32_t>(arena.size());
+        header.recipes_offset      = sizeof(snapshot::header_t);
+        header.materials_offset    = header.recipes_offset + recipes.size() * sizeof(snapshot::recipe_t);
+        header.string_index_offset = header.materials_offset + materials.size() * sizeof(snapshot::material_t);
+        header.strings_offset      = header.string_index_offset + strings.size() * sizeof(snapshot::string_t);
+
+        arena.resize(align(header.strings_offset + arena.size()) - header.strings_offset, '\0');
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open())
+        {
+            std::cout << "[!] Error: Failed to open output file for writing." << std::endl;
+            return false;
+        }
+
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(recipes.data()), recipes.size() * sizeof(snapshot::recipe_t));
+        ofs.write(reinterpret_cast<const char*>(materials.data()), materials.size() * sizeof(snapshot::material_t));
+        ofs.write(reinterpret_cast<const char*>(strings.data()), strings.size() * sizeof(snapshot::string_t));
+        ofs.write(arena.data(), arena.size());
+        ofs.close();
+
+        return !ofs.fail();
+    }
+
+    /**
+     * Memory-mapped view over a snapshot file.
+     *
+     * Opening a snapshot only validates its header and section bounds; recipes, materials and strings are read in
+     * place from the mapped file. Views returned by the snapshot remain valid for as long as it stays open.
+     */
+    class view
+    {
+        std::shared_ptr<craft_extract::mapped_file> file_;
+        const snapshot::header_t* header_{nullptr};
+        std::span<const snapshot::recipe_t> recipes_;
+        std::span<const snapshot::material_t> materials_;
+        std::span<const snapshot::string_t> strings_;
+        std::span<const char> arena_;
+
+    public:
+        /**
+         * Opens the given snapshot file.
+         *
+         * @param {std::string} path - The snapshot file to open.
+         * @return {bool} True on success, false otherwise.
+         */
+        bool open(const std::string& path)
+        {
+            this->close();
+
+            this->file_ = std::make_shared<craft_extract::mapped_file>();
+            if (!this->file_->open(path))
+            {
+                std::cout << "[!] Error: Failed to open snapshot file for reading." << std::endl;
+                this->close();
+                return false;
+            }
+
+            const auto data = this->file_->span();
+            const auto head = data.at<snapshot::header_t>(0);
+
+            if (head == nullptr || head->magic != snapshot::magic || head->version != snapshot::version)
+            {
+                std::cout << "[!] Error: Invalid or unsupported snapshot file." << std::endl;
+                this->close();
+                return false;
+            }
+
+            if (!data.contains_array<snapshot::recipe_t>(head->recipes_offset, head->recipe_count) ||
+                !data.contains_array<snapshot::material_t>(head->materials_offset, head->material_count) ||
+                !data.contains_array<snapshot::string_t>(head->string_index_offset, head->string_count) ||
+                !data.contains_array<char>(head->strings_offset, head->strings_size))
+            {
+                std::cout << "[!] Error: Invalid snapshot section information." << std::endl;
+                this->close();
+                return false;
+            }
+
+            this->header_    = head;
+            this->recipes_   = data.array<snapshot::recipe_t>(head->recipes_offset, head->recipe_count);
+            this->materials_ = data.array<snapshot::material_t>(head->materials_offset, head->material_count);
+            this->strings_   = data.array<snapshot::string_t>(head->string_index_offset, head->string_count);
+            this->arena_     = data.array<char>(head->strings_offset, head->strings_size);
+
+            return true;
+        }
+
+        /**
+         * Opens the given snapshot file, rejecting it if it was not made from the given source file.
+         *
+         * @param {std::string} path - The snapshot file to open.
+         * @param {std::string} source - The source craft file the snapshot must have been made from.
+         * @return {bool} True on success, false if the snapshot is invalid or stale.
+         */
+        bool open(const std::string& path, const std::string& source)
+        {
+            if (!this->open(path))
+                return false;
+
+            uint64_t hash = 0;
+            if (!craft_extract::cache::hash_file(source, hash) || hash != this->header_->source_hash)
+            {
+                std::cout << "[!] Error: Snapshot file is stale; its source file has changed." << std::endl;
+                this->close();
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Closes the current snapshot file.
+         */
+        void close(void)
+        {
+            this->header_    = nullptr;
+            this->recipes_   = {};
+            this->materials_ = {};
+            this->strings_   = {};
+            this->arena_     = {};
+            this->file_.reset();
+        }
+
+        /**
+         * Returns the header version of the snapshots source file.
+         *
+         * @return {uint32_t} The source file header version.
+         */
+        uint32_t source_version(void) const
+        {
+            return this->header_ != nullptr ? this->header_->source_version : 0;
+        }
+
+        /**
+         * Returns the content hash of the snapshots source file.
+         *
+         * @return {uint64_t} The source file hash.
+         */
+        uint64_t source_hash(void) const
+        {
+            return this->header_ != nullptr ? this->header_->source_hash : 0;
+        }
+
+        /**
+         * Returns the recipes of the snapshot.
+         *
+         * @return {std::span<const recipe_t>} The recipes.
+         */
+        std::span<const snapshot::recipe_t> recipes(void) const
+        {
+            return this->recipes_;
+        }
+
+        /**
+         * Returns the materials of the given recipe.
+         *
+         * @param {recipe_t} recipe - The recipe.
+         * @return {std::span<const material_t>} The materials, empty if the recipes material range is invalid.
+         */
+        std::span<const snapshot::material_t> materials(const snapshot::recipe_t& recipe) const
+        {
+            if (recipe.first_material > this->materials_.size() || recipe.material_count > this->materials_.size() - recipe.first_material)
+                return {};
+
+            return this->materials_.subspan(recipe.first_material, recipe.material_count);
+        }
+
+        /**
+         * Returns a view of the string at the given index.
+         *
+         * @param {uint32_t} index - The index of the string.
+         * @return {std::string_view} The string view, empty if the index is invalid.
+         */
+        std::string_view string(const uint32_t index) const
+        {
+            if (index >= this->strings_.size())
+                return {};
+
+            const auto& str = this->strings_[index];
+            if (str.offset > this->arena_.size() || str.size > this->arena_.size() - str.offset)
+                return {};
+
+            return std::string_view(this->arena_.data() + str.offset, str.size);
+        }
+    };
+
+} // namespace craft_extract::snapshot
+
+#endif // CRAFT_EXTRACT_SNAPSHOT_HPP
@@ -0,0 +1,495 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "errors.hpp"
+#include "recipe_reader.hpp"
+
+#include "sqlite3ext.h"
+SQLITE_EXTENSION_INIT1
+
+/**
+ * SQLite extension exposing craft files as table-valued functions:
+ *
+ *      SELECT * FROM crf_recipes('tdl.crf');
+ *      SELECT * FROM crf_materials('tdl.crf') WHERE realm_id = 0 AND profession = 'Weaponcraft';
+ *
+ * Equality filters on the realm_id, profession and category columns are pushed down into the parser, so realms,
+ * professions and categories that do not match are skipped before their recipes are read.
+ */
+namespace craft_extract::sqlite
+{
+    /**
+     * Virtual Table Column Definitions
+     *
+     * Both tables share their leading columns so that filters can be pushed down the same way.
+     */
+
+    enum class table_kind : int32_t
+    {
+        recipes   = 0,
+        materials = 1,
+    };
+
+    enum recipe_column : int32_t
+    {
+        recipe_realm_id = 0,
+        recipe_realm,
+        recipe_profession,
+        recipe_category,
+        recipe_id,
+        recipe_name,
+        recipe_base_material,
+        recipe_base_material_name,
+        recipe_icon,
+        recipe_level,
+        recipe_material_level,
+        recipe_skill,
+        recipe_file,
+    };
+
+    enum material_column : int32_t
+    {
+        material_realm_id = 0,
+        material_realm,
+        material_profession,
+        material_category,
+        material_recipe_id,
+        material_slot,
+        material_base_material,
+        material_base_material_name,
+        material_count,
+        material_name,
+        material_file,
+    };
+
+    constexpr int32_t column_realm_id   = 0;
+    constexpr int32_t column_realm_name = 1;
+    constexpr int32_t column_profession = 2;
+    constexpr int32_t column_category   = 3;
+
+    /**
+     * Virtual Table Structure Definitions
+     */
+
+    struct vtab_t : sqlite3_vtab
+    {
+        craft_extract::sqlite::table_kind kind;
+    };
+
+    struct cursor_t : sqlite3_vtab_cursor
+    {
+        craft_extract::recipe_reader reader;
+        craft_extract::craft_t craft;
+        uint32_t slot;
+        sqlite3_int64 rowid;
+        bool eof;
+    };
+
+    const auto kind_recipes   = craft_extract::sqlite::table_kind::recipes;
+    const auto kind_materials = craft_extract::sqlite::table_kind::materials;
+
+    /**
+     * Connects to a virtual table.
+     */
+    int connect(sqlite3* db, void* aux, int32_t, const char* const*, sqlite3_vtab** vtab, char**)
+    {
+        const auto kind = *static_cast<const craft_extract::sqlite::table_kind*>(aux);
+
+        const auto rc = kind == craft_extract::sqlite::table_kind::recipes
+                            ? ::sqlite3_declare_vtab(db, "CREATE TABLE x(realm_id INTEGER, realm TEXT, profession TEXT, category TEXT, id INTEGER, name TEXT, base_material INTEGER, base_material_name TEXT, icon INTEGER, level INTEGER, material_level INTEGER, skill INTEGER, file HIDDEN)")
+                            : ::sqlite3_declare_vtab(db, "CREATE TABLE x(realm_id INTEGER, realm TEXT, profession TEXT, category TEXT, recipe_id INTEGER, slot INTEGER, base_material INTEGER, base_material_name TEXT, count INTEGER, name TEXT, file HIDDEN)");
+
+        if (rc != SQLITE_OK)
+            return rc;
+
+        // The tables open arbitrary files; keep them out of triggers and views of untrusted schemas..
+        ::sqlite3_vtab_config(db, SQLITE_VTAB_DIRECTONLY);
+
+        auto table  = new craft_extract::sqlite::vtab_t{};
+        table->kind = kind;
+        *vtab       = table;
+
+        return SQLITE_OK;
+    }
+
+    /**
+     * Disconnects from a virtual table.
+     */
+    int disconnect(sqlite3_vtab* vtab)
+    {
+        delete static_cast<craft_extract::sqlite::vtab_t*>(vtab);
+        return SQLITE_OK;
+    }
+
+    /**
+     * Selects the query plan of a virtual table scan.
+     *
+     * idxNum bit 1 is set when a realm filter is passed, bit 2 when a profession filter is passed and bit 4 when a
+     * category filter is passed. The file argument is always passed first, followed by the realm, profession and
+     * category values in that order.
+     */
+    int best_index(sqlite3_vtab* vtab, sqlite3_index_info* info)
+    {
+        const auto file_column = static_cast<craft_extract::sqlite::vtab_t*>(vtab)->kind == craft_extract::sqlite::table_kind::recipes
+                                     ? static_cast<int32_t>(craft_extract::sqlite::recipe_file)
+                                     : static_cast<int32_t>(craft_extract::sqlite::material_file);
+
+        auto file       = -1;
+        auto realm      = -1;
+        auto profession = -1;
+        auto category   = -1;
+
+        for (auto x = 0; x < info->nConstraint; x++)
+        {
+            const auto& c = info->aConstraint[x];
+
+            if (c.iColumn == file_column)
+            {
+                // The file argument is required; reject plans where it cannot be provided..
+                if (!c.usable || c.op != SQLITE_INDEX_CONSTRAINT_EQ)
+                    return SQLITE_CONSTRAINT;
+
+                file = x;
+                continue;
+            }
+
+            if (!c.usable || c.op != SQLITE_INDEX_CONSTRAINT_EQ)
+                continue;
+
+            if (c.iColumn == craft_extract::sqlite::column_realm_id)
+                realm = x;
+            else if (c.iColumn == craft_extract::sqlite::column_profession)
+                profession = x;
+            else if (c.iColumn == craft_extract::sqlite::column_category)
+                category = x;
+        }
+
+        // Plans without the file argument are rejected; SQLite reports queries that never pass it as having no plan..
+        if (file == -1)
+            return SQLITE_CONSTRAINT;
+
+        auto argc = 1;
+
+        info->aConstraintUsage[file].argvIndex = argc++;
+        info->aConstraintUsage[file].omit      = 1;
+        info->idxNum                           = 0;
+        info->estimatedCost                    = 100000;
+
+        if (realm != -1)
+        {
+            info->aConstraintUsage[realm].argvIndex = argc++;
+            info->idxNum |= 1;
+            info->estimatedCost /= 3;
+        }
+        if (profession != -1)
+        {
+            info->aConstraintUsage[profession].argvIndex = argc++;
+            info->idxNum |= 2;
+            info->estimatedCost /= 20;
+        }
+        if (category != -1)
+        {
+            info->aConstraintUsage[category].argvIndex = argc++;
+            info->idxNum |= 4;
+            info->estimatedCost /= 50;
+        }
+
+        return SQLITE_OK;
+    }
+
+    /**
+     * Opens a new cursor over a virtual table.
+     */
+    int open(sqlite3_vtab*, sqlite3_vtab_cursor** cursor)
+    {
+        *cursor = new craft_extract::sqlite::cursor_t{};
+        return SQLITE_OK;
+    }
+
+    /**
+     * Closes a cursor.
+     */
+    int close(sqlite3_vtab_cursor* cursor)
+    {
+        delete static_cast<craft_extract::sqlite::cursor_t*>(cursor);
+        return SQLITE_OK;
+    }
+
+    /**
+     * Starts a virtual table scan; opens the requested file with the pushed down filters.
+     */
+    int filter(sqlite3_vtab_cursor* cursor, int32_t idx_num, const char*, int32_t argc, sqlite3_value** argv)
+    {
+        auto cur  = static_cast<craft_extract::sqlite::cursor_t*>(cursor);
+        auto vtab = static_cast<craft_extract::sqlite::vtab_t*>(cursor->pVtab);
+
+        cur->reader.close();
+        cur->slot  = 0;
+        cur->rowid = 0;
+        cur->eof   = true;
+
+        if (argc < 1 || ::sqlite3_value_type(argv[0]) == SQLITE_NULL)
+            return SQLITE_OK;
+
+        const auto file = reinterpret_cast<const char*>(::sqlite3_value_text(argv[0]));
+
+        craft_extract::parse_options options{};
+        auto arg = 1;
+
+        if (idx_num & 1)
+        {
+            // Only integer realm values are pushed down; SQLite still checks the constraint against every row..
+            const auto realm = argv[arg++];
+            if (::sqlite3_value_numeric_type(realm) == SQLITE_INTEGER)
+            {
+                const auto value = ::sqlite3_value_int64(realm);
+                if (value < 0 || value >= static_cast<sqlite3_int64>(craft_extract::realm_names.size()))
+                    return SQLITE_OK;
+
+                options.realm = static_cast<int32_t>(value);
+            }
+        }
+        if (idx_num & 2)
+        {
+            const auto profession = ::sqlite3_value_text(argv[arg++]);
+            if (profession == nullptr)
+                return SQLITE_OK;
+
+            options.profession = reinterpret_cast<const char*>(profession);
+        }
+        if (idx_num & 4)
+        {
+            const auto category = ::sqlite3_value_text(argv[arg++]);
+            if (category == nullptr)
+                return SQLITE_OK;
+
+            options.category = reinterpret_cast<const char*>(category);
+        }
+
+        // Recipes are read lazily as the scan advances; scans that stop early never read the rest of the file..
+        craft_extract::error_capture errors;
+        if (!cur->reader.open(file, options))
+        {
+            ::sqlite3_free(vtab->zErrMsg);
+            vtab->zErrMsg = errors.message().empty()
+                                ? ::sqlite3_mprintf("failed to parse crf file: %s", file)
+                                : ::sqlite3_mprintf("failed to parse crf file: %s; %s", file, errors.message().c_str());
+            return SQLITE_ERROR;
+        }
+
+        cur->eof = !cur->reader.next(cur->craft);
+        return SQLITE_OK;
+    }
+
+    /**
+     * Advances a cursor to the next row.
+     */
+    int next(sqlite3_vtab_cursor* cursor)
+    {
+        auto cur  = static_cast<craft_extract::sqlite::cursor_t*>(cursor);
+        auto vtab = static_cast<craft_extract::sqlite::vtab_t*>(cursor->pVtab);
+
+        cur->rowid++;
+
+        // Move to the next material of the current recipe, if any..
+        if (vtab->kind == craft_extract::sqlite::table_kind::materials && ++cur->slot < cur->craft.materials.size())
+            return SQLITE_OK;
+
+        cur->slot = 0;
+        cur->eof  = !cur->reader.next(cur->craft);
+
+        return SQLITE_OK;
+    }
+
+    /**
+     * Returns if a cursor has moved past the last row.
+     */
+    int eof(sqlite3_vtab_cursor* cursor)
+    {
+        return static_cast<craft_extract::sqlite::cursor_t*>(cursor)->eof;
+    }
+
+    /**
+     * Returns a text value from a column.
+     */
+    void result_text(sqlite3_context* ctx, const std::string_view value)
+    {
+        ::sqlite3_result_text(ctx, value.data(), static_cast<int32_t>(value.size()), SQLITE_TRANSIENT);
+    }
+
+    /**
+     * Returns the value of a column of the current row.
+     */
+    int column(sqlite3_vtab_cursor* cursor, sqlite3_context* ctx, int32_t col)
+    {
+        const auto cur      = static_cast<craft_extract::sqlite::cursor_t*>(cursor);
+        const auto vtab     = static_cast<craft_extract::sqlite::vtab_t*>(cursor->pVtab);
+        const auto& craft   = cur->craft;
+        const auto& strings = cur->reader.strings();
+
+        // Handle the shared leading columns..
+        switch (col)
+        {
+            case craft_extract::sqlite::column_realm_id:
+                ::sqlite3_result_int(ctx, craft.name_index_realm);
+                return SQLITE_OK;
+            case craft_extract::sqlite::column_realm_name:
+                craft_extract::sqlite::result_text(ctx, realm_names[craft.name_index_realm]);
+                return SQLITE_OK;
+            case craft_extract::sqlite::column_profession:
+                craft_extract::sqlite::result_text(ctx, strings[craft.name_index_profession]);
+                return SQLITE_OK;
+            case craft_extract::sqlite::column_category:
+                craft_extract::sqlite::result_text(ctx, strings[craft.name_index_category]);
+                return SQLITE_OK;
+        }
+
+        if (vtab->kind == craft_extract::sqlite::table_kind::recipes)
+        {
+            switch (col)
+            {
+                case craft_extract::sqlite::recipe_id:
+                    ::sqlite3_result_int64(ctx, craft.id);
+                    break;
+                case craft_extract::sqlite::recipe_name:
+                    craft_extract::sqlite::result_text(ctx, strings[craft.name_index_recipe]);
+                    break;
+                case craft_extract::sqlite::recipe_base_material:
+                    ::sqlite3_result_int64(ctx, craft.base_material);
+                    break;
+                case craft_extract::sqlite::recipe_base_material_name:
+                    craft_extract::sqlite::result_text(ctx, craft_extract::base_material_name(craft.base_material));
+                    break;
+                case craft_extract::sqlite::recipe_icon:
+                    ::sqlite3_result_int(ctx, craft.icon);
+                    break;
+                case craft_extract::sqlite::recipe_level:
+                    ::sqlite3_result_int(ctx, craft.level);
+                    break;
+                case craft_extract::sqlite::recipe_material_level:
+                    ::sqlite3_result_int(ctx, craft.material_level);
+                    break;
+                case craft_extract::sqlite::recipe_skill:
+                    ::sqlite3_result_int(ctx, craft.skill);
+                    break;
+                default:
+                    ::sqlite3_result_null(ctx);
+                    break;
+            }
+
+            return SQLITE_OK;
+        }
+
+        const auto& mat = craft.materials[cur->slot];
+
+        switch (col)
+        {
+            case craft_extract::sqlite::material_recipe_id:
+                ::sqlite3_result_int64(ctx, craft.id);
+                break;
+            case craft_extract::sqlite::material_slot:
+                ::sqlite3_result_int(ctx, cur->slot);
+                break;
+            case craft_extract::sqlite::material_base_material:
+                ::sqlite3_result_int(ctx, mat.base_material);
+                break;
+            case craft_extract::sqlite::material_base_material_name:
+                craft_extract::sqlite::result_text(ctx, craft_extract::base_material_name(mat.base_material));
+                break;
+            case craft_extract::sqlite::material_count:
+                ::sqlite3_result_int(ctx, mat.count);
+                break;
+            case craft_extract::sqlite::material_name:
+                craft_extract::sqlite::result_text(ctx, strings[mat.name_index]);
+                break;
+            default:
+                ::sqlite3_result_null(ctx);
+                break;
+        }
+
+        return SQLITE_OK;
+    }
+
+    /**
+     * Returns the rowid of the current row.
+     */
+    int rowid(sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid)
+    {
+        *rowid = static_cast<craft_extract::sqlite::cursor_t*>(cursor)->rowid;
+        return SQLITE_OK;
+    }
+
+    /**
+     * Virtual table module definition. (Eponymous-only; the tables are used as table-valued functions.)
+     */
+    sqlite3_module module = {
+        .iVersion      = 0,
+        .xCreate       = nullptr,
+        .xConnect      = craft_extract::sqlite::connect,
+        .xBestIndex    = craft_extract::sqlite::best_index,
+        .xDisconnect   = craft_extract::sqlite::disconnect,
+        .xDestroy      = nullptr,
+        .xOpen         = craft_extract::sqlite::open,
+        .xClose        = craft_extract::sqlite::close,
+        .xFilter       = craft_extract::sqlite::filter,
+        .xNext         = craft_extract::sqlite::next,
+        .xEof          = craft_extract::sqlite::eof,
+        .xColumn       = craft_extract::sqlite::column,
+        .xRowid        = craft_extract::sqlite::rowid,
+        .xUpdate       = nullptr,
+        .xBegin        = nullptr,
+        .xSync         = nullptr,
+        .xCommit       = nullptr,
+        .xRollback     = nullptr,
+        .xFindFunction = nullptr,
+        .xRename       = nullptr,
+        .xSavepoint    = nullptr,
+        .xRelease      = nullptr,
+        .xRollbackTo   = nullptr,
+        .xShadowName   = nullptr,
+    };
+
+} // namespace craft_extract::sqlite
+
+/**
+ * SQLite extension entry point.
+ *
+ * @param {sqlite3*} db - The database connection loading the extension.
+ * @param {char**} err - Pointer to receive an error message on failure.
+ * @param {sqlite3_api_routines*} api - The SQLite API routines.
+ * @return {int} SQLITE_OK on success, an SQLite error code otherwise.
+ */
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#endif
+int sqlite3_crf_init(sqlite3* db, char** err, const sqlite3_api_routines* api)
+{
+    SQLITE_EXTENSION_INIT2(api);
+
+    auto rc = ::sqlite3_create_module(db, "crf_recipes", &craft_extract::sqlite::module, const_cast<craft_extract::sqlite::table_kind*>(&craft_extract::sqlite::kind_recipes));
+    if (rc == SQLITE_OK)
+        rc = ::sqlite3_create_module(db, "crf_materials", &craft_extract::sqlite::module, const_cast<craft_extract::sqlite::table_kind*>(&craft_extract::sqlite::kind_materials));
+
+    if (rc != SQLITE_OK && err != nullptr)
+        *err = ::sqlite3_mprintf("failed to register the crf virtual tables: %s", ::sqlite3_errstr(rc));
+
+    return rc;
+}
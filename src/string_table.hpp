@@ -0,0 +1,130 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_STRING_TABLE_HPP
+#define CRAFT_EXTRACT_STRING_TABLE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "mapped_file.hpp"
+
+namespace craft_extract
+{
+    /**
+     * Craft file string table.
+     *
+     * Entries are views into the raw strings block of the input file; the table retains the owner of the block so
+     * the views remain valid for as long as the table does. Owned copies are only made when requested.
+     */
+    class string_table
+    {
+        std::shared_ptr<const void> owner_;
+        std::vector<std::string_view> entries_;
+
+    public:
+        /**
+         * Loads the string table from the given strings block and index table.
+         *
+         * The strings block is immediately followed by the index table, which holds the offset of each string
+         * within the block. Strings are null terminated; the block is padded with two additional bytes.
+         *
+         * @param {byte_span} data - View over the mapped input file.
+         * @param {std::size_t} offset - The offset of the strings block.
+         * @param {uint32_t} block_size - The size of the strings block, in bytes.
+         * @param {uint32_t} count - The number of strings in the table.
+         * @return {bool} True on success, false otherwise.
+         */
+        bool load(const craft_extract::byte_span& data, const std::size_t offset, const uint32_t block_size, const uint32_t count)
+        {
+            this->clear();
+
+            if (count == 0 || block_size < 3 || !data.contains(offset, block_size) || !data.contains_array<uint32_t>(offset + block_size, count))
+                return false;
+
+            const auto block = reinterpret_cast<const char*>(data.data() + offset);
+            const auto index = data.array<uint32_t>(offset + block_size, count);
+
+            this->entries_.reserve(count);
+
+            for (auto x = 0u; x < count; x++)
+            {
+                const auto start = index[x];
+                const auto end   = x + 1 < count ? index[x + 1] - 1 : block_size - 3;
+
+                if (start > end || end > block_size || (x + 1 < count && index[x + 1] == 0))
+                {
+                    this->clear();
+                    return false;
+                }
+
+                this->entries_.emplace_back(block + start, end - start);
+            }
+
+            this->owner_ = data.owner();
+            return true;
+        }
+
+        /**
+         * Clears the string table, releasing the strings block.
+         */
+        void clear(void)
+        {
+            this->entries_.clear();
+            this->owner_.reset();
+        }
+
+        /**
+         * Returns the number of strings in the table.
+         *
+         * @return {std::size_t} The number of strings.
+         */
+        std::size_t size(void) const
+        {
+            return this->entries_.size();
+        }
+
+        /**
+         * Returns a view of the string at the given index.
+         *
+         * @param {std::size_t} index - The index of the string.
+         * @return {std::string_view} The string view, empty if the index is out of range.
+         */
+        std::string_view operator[](const std::size_t index) const
+        {
+            return index < this->entries_.size() ? this->entries_[index] : std::string_view();
+        }
+
+        /**
+         * Returns an owned copy of the string at the given index.
+         *
+         * @param {std::size_t} index - The index of the string.
+         * @return {std::string} The string, empty if the index is out of range.
+         */
+        std::string str(const std::size_t index) const
+        {
+            return std::string((*this)[index]);
+        }
+    };
+
+} // namespace craft_extract
+
+#endif // CRAFT_EXTRACT_STRING_TABLE_HPP
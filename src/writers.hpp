@@ -0,0 +1,1107 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_WRITERS_HPP
+#define CRAFT_EXTRACT_WRITERS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "craft_queue.hpp"
+#include "crafts.hpp"
+#include "output_buffer.hpp"
+#include "snapshot.hpp"
+
+#include "sqlite3.h"
+#include "SQLiteCpp/SQLiteCpp.h"
+#include "SQLiteCpp/Transaction.h"
+
+namespace craft_extract::writers
+{
+    /**
+     * Returns a recipe batch source over the given parsed craft information.
+     *
+     * Writers that accept a batch source call it with a callback, which is invoked once per batch of recipes as
+     * fn(realm, crafts), in realm order. Sources can walk a complete parse result, or receive batches from a parser
+     * that is still running. (See stream.)
+     *
+     * @param {parse_result} result - The parsed craft information.
+     * @return {auto} The recipe batch source.
+     */
+    inline auto batches(const craft_extract::parse_result& result)
+    {
+        return [&result](auto&& fn) {
+            for (const auto& r : result.crafts)
+                fn(r.first, std::span<const craft_extract::craft_t>(r.second));
+        };
+    }
+
+    /**
+     * Writes craft recipes to a csv file.
+     *
+     * @param {string_table} strings - The string table of the recipes.
+     * @param {Source} source - The source of the recipe batches to save. (See batches.)
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Source>
+    bool write_csv(const craft_extract::string_table& strings, Source&& source, const std::string& path)
+    {
+        // Open the output file for writing..
+        craft_extract::output_buffer out;
+        if (!out.open(path))
+        {
+            std::cout << "[!] Failed to open output file for writing!" << std::endl;
+            return false;
+        }
+
+        // Write the main csv header row..
+        out.append("id, realm, realm_name, profession, category, name, base_material, base_material_name, icon, level, material_level, skill, mat1_base_material, mat1_base_material_name, mat1_count, mat1_name, mat2_base_material, mat2_base_material_name, mat2_count, mat2_name, mat3_base_material, mat3_base_material_name, mat3_count, mat3_name, mat4_base_material, mat4_base_material_name, mat4_count, mat4_name, mat5_base_material, mat5_base_material_name, mat5_count, mat5_name, mat6_base_material, mat6_base_material_name, mat6_count, mat6_name, mat7_base_material, mat7_base_material_name, mat7_count, mat7_name, mat8_base_material, mat8_base_material_name, mat8_count, mat8_name");
+        out.append('\n');
+
+        // Write the recipes..
+        source([&](const uint32_t realm, const std::span<const craft_extract::craft_t> crafts) {
+            for (auto riter = crafts.begin(), riterend = crafts.end(); riter != riterend; ++riter)
+            {
+                out.append_number(riter->id);
+                out.append(',');
+                out.append_number(realm);
+                out.append(',');
+                out.append(realm_names[realm]);
+                out.append(',');
+                out.append(strings[riter->name_index_profession]);
+                out.append(',');
+                out.append(strings[riter->name_index_category]);
+                out.append(',');
+                out.append(strings[riter->name_index_recipe]);
+                out.append(',');
+                out.append_number(riter->base_material);
+                out.append(',');
+                out.append(craft_extract::base_material_name(riter->base_material));
+                out.append(',');
+                out.append_number(riter->icon);
+                out.append(',');
+                out.append_number(riter->level);
+                out.append(',');
+                out.append_number(riter->material_level);
+                out.append(',');
+                out.append_number(riter->skill);
+
+                for (const auto& m : riter->materials)
+                {
+                    out.append(',');
+                    out.append_number(m.base_material);
+                    out.append(',');
+                    out.append(craft_extract::base_material_name(m.base_material));
+                    out.append(',');
+                    out.append_number(m.count);
+                    out.append(',');
+                    out.append(strings[m.name_index]);
+                }
+
+                out.append('\n');
+            }
+        });
+
+        if (!out.close())
+        {
+            std::cout << "[!] Failed to write output file!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Saves the parsed craft recipes to a csv file.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_csv(const craft_extract::parse_result& result, const std::string& path)
+    {
+        return craft_extract::writers::write_csv(result.strings, craft_extract::writers::batches(result), path);
+    }
+
+    /**
+     * Appends a quoted, escaped JSON string to the output.
+     *
+     * @param {output_buffer} out - The output to append to.
+     * @param {std::string_view} str - The string to append.
+     */
+    inline void append_json_string(craft_extract::output_buffer& out, const std::string_view str)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        out.append('"');
+
+        for (const auto c : str)
+        {
+            switch (c)
+            {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\b':
+                    out.append("\\b");
+                    break;
+                case '\f':
+                    out.append("\\f");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default:
+                    if (static_cast<uint8_t>(c) < 0x20)
+                    {
+                        out.append("\\u00");
+                        out.append(hex[(c >> 4) & 0x0F]);
+                        out.append(hex[c & 0x0F]);
+                    }
+                    else
+                        out.append(c);
+                    break;
+            }
+        }
+
+        out.append('"');
+    }
+
+    /**
+     * Saves the parsed craft recipes to a JSON file.
+     *
+     * Recipes are streamed directly into the output as they are written, without building a document in memory. The
+     * output layout matches a sorted-key, two-space indented document. (Realms and keys are written in name order.)
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_json(const craft_extract::parse_result& result, const std::string& path)
+    {
+        // Open the output file for writing..
+        craft_extract::output_buffer out(1024 * 1024);
+        if (!out.open(path))
+        {
+            std::cout << "[!] Failed to open output file for writing!" << std::endl;
+            return false;
+        }
+
+        // Order the realms by name..
+        std::vector<uint32_t> realms;
+        for (const auto& r : result.crafts)
+            realms.push_back(r.first);
+        std::ranges::sort(realms, {}, [](const uint32_t r) -> const std::string& { return realm_names[r]; });
+
+        // Writes a numeric property of an object..
+        const auto number = [&out](const std::string_view indent, const std::string_view key, const auto value) {
+            out.append(indent);
+            out.append('"');
+            out.append(key);
+            out.append("\": ");
+            out.append_number(value);
+            out.append(",\n");
+        };
+
+        // Writes a string property of an object..
+        const auto string = [&out](const std::string_view indent, const std::string_view key, const std::string_view value, const bool last) {
+            out.append(indent);
+            out.append('"');
+            out.append(key);
+            out.append("\": ");
+            append_json_string(out, value);
+            out.append(last ? "\n" : ",\n");
+        };
+
+        if (realms.empty())
+            out.append("null");
+        else
+            out.append("{\n");
+
+        // Write the recipes of each realm..
+        for (auto x = 0u; x < realms.size(); x++)
+        {
+            const auto& crafts = result.crafts.at(realms[x]);
+
+            out.append("  ");
+            append_json_string(out, realm_names[realms[x]]);
+            out.append(crafts.empty() ? ": null" : ": [\n");
+
+            for (auto riter = crafts.begin(), riterend = crafts.end(); riter != riterend; ++riter)
+            {
+                out.append("    {\n");
+                number("      ", "base_material", riter->base_material);
+                string("      ", "base_material_name", craft_extract::base_material_name(riter->base_material), false);
+                string("      ", "category", result.strings[riter->name_index_category], false);
+                number("      ", "icon", riter->icon);
+                number("      ", "id", riter->id);
+                number("      ", "level", riter->level);
+                number("      ", "material_level", riter->material_level);
+
+                out.append("      \"materials\": ");
+
+                if (riter->materials.empty())
+                    out.append("null,\n");
+                else
+                {
+                    out.append("[\n");
+
+                    for (auto m = 0u; m < riter->materials.size(); m++)
+                    {
+                        const auto& mat = riter->materials[m];
+
+                        out.append("        {\n");
+                        number("          ", "base_material", mat.base_material);
+                        string("          ", "base_material_name", craft_extract::base_material_name(mat.base_material), false);
+                        number("          ", "count", mat.count);
+                        string("          ", "name", result.strings[mat.name_index], true);
+                        out.append(m + 1 < riter->materials.size() ? "        },\n" : "        }\n");
+                    }
+
+                    out.append("      ],\n");
+                }
+
+                string("      ", "name", result.strings[riter->name_index_recipe], false);
+                string("      ", "profession", result.strings[riter->name_index_profession], false);
+
+                out.append("      \"skill\": ");
+                out.append_number(riter->skill);
+                out.append(riter + 1 != riterend ? "\n    },\n" : "\n    }\n");
+            }
+
+            if (!crafts.empty())
+                out.append("  ]");
+            out.append(x + 1 < realms.size() ? ",\n" : "\n}");
+        }
+
+        if (!out.close())
+        {
+            std::cout << "[!] Failed to write output file!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Configures an SQLite database for bulk loading.
+     *
+     * Journaling and syncing are disabled; the database is only ever written by a single export that starts from
+     * an empty file, so a failed export is discarded rather than recovered.
+     *
+     * @param {SQLite::Database} db - The database to configure.
+     */
+    inline void configure_bulk_load(SQLite::Database& db)
+    {
+        db.exec("PRAGMA journal_mode = OFF;");
+        db.exec("PRAGMA synchronous = OFF;");
+        db.exec("PRAGMA locking_mode = EXCLUSIVE;");
+        db.exec("PRAGMA temp_store = MEMORY;");
+        db.exec("PRAGMA cache_size = -65536;");
+    }
+
+    /**
+     * Prepared SQLite insert statement for the bulk loading loops.
+     *
+     * Text values are bound directly from string table views, without copying each one into a std::string first;
+     * the views must remain valid until the statement is executed.
+     */
+    class insert_statement
+    {
+        sqlite3* db_;
+        sqlite3_stmt* stmt_{nullptr};
+
+        void check(const int32_t rc) const
+        {
+            if (rc != SQLITE_OK)
+                throw SQLite::Exception(this->db_, rc);
+        }
+
+    public:
+        insert_statement(SQLite::Database& db, const char* sql)
+            : db_(db.getHandle())
+        {
+            this->check(::sqlite3_prepare_v2(this->db_, sql, -1, &this->stmt_, nullptr));
+        }
+        ~insert_statement(void)
+        {
+            ::sqlite3_finalize(this->stmt_);
+        }
+
+        insert_statement(const insert_statement&)            = delete;
+        insert_statement& operator=(const insert_statement&) = delete;
+
+        /**
+         * Binds an integer value to a parameter.
+         *
+         * @param {int32_t} index - The parameter index, starting at 1.
+         * @param {int64_t} value - The value to bind.
+         */
+        void bind(const int32_t index, const int64_t value)
+        {
+            this->check(::sqlite3_bind_int64(this->stmt_, index, value));
+        }
+
+        /**
+         * Binds a text value to a parameter, without copying it.
+         *
+         * @param {int32_t} index - The parameter index, starting at 1.
+         * @param {std::string_view} value - The value to bind.
+         */
+        void bind(const int32_t index, const std::string_view value)
+        {
+            this->check(::sqlite3_bind_text(this->stmt_, index, value.empty() ? "" : value.data(), static_cast<int32_t>(value.size()), SQLITE_STATIC));
+        }
+
+        /**
+         * Executes the statement and resets it for the next row.
+         */
+        void exec(void)
+        {
+            const auto rc = ::sqlite3_step(this->stmt_);
+            ::sqlite3_reset(this->stmt_);
+
+            if (rc != SQLITE_DONE)
+                throw SQLite::Exception(this->db_, rc);
+        }
+    };
+
+    /**
+     * Writes craft recipes to an SQLite database file.
+     *
+     * @param {string_table} strings - The string table of the recipes.
+     * @param {Source} source - The source of the recipe batches to save. (See batches.)
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Source>
+    bool write_sqlite(const craft_extract::string_table& strings, Source&& source, const std::string& path)
+    {
+        // Remove any existing output file; the database is always written from scratch..
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+
+        try
+        {
+            SQLite::Database db(path, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+
+            configure_bulk_load(db);
+
+            // Prepare the various database tables..
+            db.exec("CREATE TABLE about_craft_extract (created_by TEXT, paypal TEXT, github TEXT, patreon TEXT, repo TEXT);");
+            db.exec("CREATE TABLE base_materials (id INT, name TEXT);");
+            db.exec("CREATE TABLE realms (id INT, name TEXT);");
+            db.exec("CREATE TABLE recipes (id INT, realm_id INT, profession TEXT, category TEXT, name TEXT, base_material INT, icon INT, level INT, material_level INT, skill INT);");
+            db.exec("CREATE TABLE recipes_materials (recipe_id INT, base_material INT, count INT, name TEXT);");
+
+            // Write all information within a single transaction..
+            SQLite::Transaction transaction(db);
+
+            // Write the credits information..
+            db.exec("INSERT INTO about_craft_extract VALUES('atom0s', 'https://paypal.me/atom0s', 'https://github.com/sponsors/atom0s', 'https://patreon.com/atom0s', 'https://github.com/atom0s/craft_extract');");
+
+            // Write the base materials information..
+            SQLite::Statement insert_base_material(db, "INSERT INTO base_materials VALUES(?, ?);");
+            for (auto x = 0u; x < base_materials.size(); x++)
+            {
+                insert_base_material.bind(1, x);
+                insert_base_material.bind(2, base_materials[x]);
+                insert_base_material.exec();
+                insert_base_material.reset();
+            }
+
+            // Write the realms information..
+            SQLite::Statement insert_realm(db, "INSERT INTO realms VALUES(?, ?);");
+            for (auto x = 0u; x < realm_names.size(); x++)
+            {
+                insert_realm.bind(1, x);
+                insert_realm.bind(2, realm_names[x]);
+                insert_realm.exec();
+                insert_realm.reset();
+            }
+
+            // Write the recipes information..
+            craft_extract::writers::insert_statement insert_recipe(db, "INSERT INTO recipes VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
+            craft_extract::writers::insert_statement insert_material(db, "INSERT INTO recipes_materials VALUES(?, ?, ?, ?);");
+
+            source([&](const uint32_t realm, const std::span<const craft_extract::craft_t> crafts) {
+                for (auto riter = crafts.begin(), riterend = crafts.end(); riter != riterend; ++riter)
+                {
+                    insert_recipe.bind(1, riter->id);
+                    insert_recipe.bind(2, realm);
+                    insert_recipe.bind(3, strings[riter->name_index_profession]);
+                    insert_recipe.bind(4, strings[riter->name_index_category]);
+                    insert_recipe.bind(5, strings[riter->name_index_recipe]);
+                    insert_recipe.bind(6, riter->base_material);
+                    insert_recipe.bind(7, riter->icon);
+                    insert_recipe.bind(8, riter->level);
+                    insert_recipe.bind(9, riter->material_level);
+                    insert_recipe.bind(10, riter->skill);
+                    insert_recipe.exec();
+
+                    for (const auto& m : riter->materials)
+                    {
+                        insert_material.bind(1, riter->id);
+                        insert_material.bind(2, m.base_material);
+                        insert_material.bind(3, m.count);
+                        insert_material.bind(4, strings[m.name_index]);
+                        insert_material.exec();
+                    }
+                }
+            });
+
+            // Build the indices once all information has been loaded..
+            db.exec("CREATE INDEX recipes_realm_id ON recipes (realm_id, id);");
+            db.exec("CREATE INDEX recipes_materials_recipe_id ON recipes_materials (recipe_id);");
+
+            transaction.commit();
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "[!] Failed to save sqlite file; caught exception:"
+                      << std::endl
+                      << std::endl
+                      << e.what()
+                      << std::endl;
+
+            std::filesystem::remove(path, ec);
+            return false;
+        }
+    }
+
+    /**
+     * Saves the parsed craft recipes to an SQLite database file.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_sqlite(const craft_extract::parse_result& result, const std::string& path)
+    {
+        return craft_extract::writers::write_sqlite(result.strings, craft_extract::writers::batches(result), path);
+    }
+
+    /**
+     * Writes craft recipes to a normalized SQLite database file.
+     *
+     * Names are stored once in the strings table, keyed by their string table index, and referenced by id from the
+     * recipe and material tables. Recipes and materials are stored in WITHOUT ROWID tables keyed by their natural
+     * keys, with covering indices for the common profession, skill and material lookups.
+     *
+     * @param {string_table} strings - The string table of the recipes.
+     * @param {Source} source - The source of the recipe batches to save. (See batches.)
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Source>
+    bool write_sqlite_normalized(const craft_extract::string_table& strings, Source&& source, const std::string& path)
+    {
+        // Remove any existing output file; the database is always written from scratch..
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+
+        try
+        {
+            SQLite::Database db(path, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+            configure_bulk_load(db);
+
+            // Prepare the various database tables..
+            db.exec("CREATE TABLE about_craft_extract (created_by TEXT, paypal TEXT, github TEXT, patreon TEXT, repo TEXT);");
+            db.exec("CREATE TABLE base_materials (id INTEGER PRIMARY KEY, name TEXT NOT NULL);");
+            db.exec("CREATE TABLE realms (id INTEGER PRIMARY KEY, name TEXT NOT NULL);");
+            db.exec("CREATE TABLE strings (id INTEGER PRIMARY KEY, value TEXT NOT NULL);");
+            db.exec("CREATE TABLE recipes ("
+                    "realm_id INTEGER NOT NULL REFERENCES realms (id), "
+                    "profession_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "category_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "id INTEGER NOT NULL, "
+                    "name_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "base_material INTEGER NOT NULL REFERENCES base_materials (id), "
+                    "icon INTEGER NOT NULL, "
+                    "level INTEGER NOT NULL, "
+                    "material_level INTEGER NOT NULL, "
+                    "skill INTEGER NOT NULL, "
+                    "PRIMARY KEY (realm_id, profession_id, category_id, id)) WITHOUT ROWID;");
+            db.exec("CREATE TABLE recipes_materials ("
+                    "realm_id INTEGER NOT NULL REFERENCES realms (id), "
+                    "recipe_id INTEGER NOT NULL, "
+                    "slot INTEGER NOT NULL, "
+                    "name_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "base_material INTEGER NOT NULL REFERENCES base_materials (id), "
+                    "count INTEGER NOT NULL, "
+                    "PRIMARY KEY (realm_id, recipe_id, slot)) WITHOUT ROWID;");
+
+            // Write all information within a single transaction..
+            SQLite::Transaction transaction(db);
+
+            // Write the credits information..
+            db.exec("INSERT INTO about_craft_extract VALUES('atom0s', 'https://paypal.me/atom0s', 'https://github.com/sponsors/atom0s', 'https://patreon.com/atom0s', 'https://github.com/atom0s/craft_extract');");
+
+            // Write the base materials information..
+            SQLite::Statement insert_base_material(db, "INSERT INTO base_materials VALUES(?, ?);");
+            for (auto x = 0u; x < base_materials.size(); x++)
+            {
+                insert_base_material.bind(1, x);
+                insert_base_material.bind(2, base_materials[x]);
+                insert_base_material.exec();
+                insert_base_material.reset();
+            }
+
+            // Write the realms information..
+            SQLite::Statement insert_realm(db, "INSERT INTO realms VALUES(?, ?);");
+            for (auto x = 0u; x < realm_names.size(); x++)
+            {
+                insert_realm.bind(1, x);
+                insert_realm.bind(2, realm_names[x]);
+                insert_realm.exec();
+                insert_realm.reset();
+            }
+
+            // Write the recipes information.. (Recipes listed more than once within a category are only stored once.)
+            SQLite::Statement insert_recipe(db, "INSERT OR IGNORE INTO recipes VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
+            SQLite::Statement insert_material(db, "INSERT OR IGNORE INTO recipes_materials VALUES(?, ?, ?, ?, ?, ?);");
+
+            source([&](const uint32_t realm, const std::span<const craft_extract::craft_t> crafts) {
+                for (auto riter = crafts.begin(), riterend = crafts.end(); riter != riterend; ++riter)
+                {
+                    insert_recipe.bind(1, realm);
+                    insert_recipe.bind(2, riter->name_index_profession);
+                    insert_recipe.bind(3, riter->name_index_category);
+                    insert_recipe.bind(4, riter->id);
+                    insert_recipe.bind(5, riter->name_index_recipe);
+                    insert_recipe.bind(6, riter->base_material);
+                    insert_recipe.bind(7, riter->icon);
+                    insert_recipe.bind(8, riter->level);
+                    insert_recipe.bind(9, riter->material_level);
+                    insert_recipe.bind(10, riter->skill);
+                    insert_recipe.exec();
+                    insert_recipe.reset();
+
+                    for (auto m = 0u; m < riter->materials.size(); m++)
+                    {
+                        const auto& mat = riter->materials[m];
+
+                        insert_material.bind(1, realm);
+                        insert_material.bind(2, riter->id);
+                        insert_material.bind(3, m);
+                        insert_material.bind(4, mat.name_index);
+                        insert_material.bind(5, mat.base_material);
+                        insert_material.bind(6, mat.count);
+                        insert_material.exec();
+                        insert_material.reset();
+                    }
+                }
+            });
+
+            // Write the strings information.. (Written last; when streaming, the string table is only complete once all recipes were received.)
+            SQLite::Statement insert_string(db, "INSERT INTO strings VALUES(?, ?);");
+            for (auto x = 0u; x < strings.size(); x++)
+            {
+                insert_string.bind(1, x);
+                insert_string.bind(2, strings.str(x));
+                insert_string.exec();
+                insert_string.reset();
+            }
+
+            // Build the covering indices once all information has been loaded..
+            db.exec("CREATE INDEX recipes_by_skill ON recipes (realm_id, skill, profession_id, id);");
+            db.exec("CREATE INDEX recipes_by_name ON recipes (name_id, realm_id, id);");
+            db.exec("CREATE INDEX recipes_materials_by_material ON recipes_materials (name_id, realm_id, recipe_id, count);");
+
+            // Provide a view resolving the names of each recipe..
+            db.exec("CREATE VIEW recipes_named AS "
+                    "SELECT r.id, r.realm_id, p.value AS profession, c.value AS category, n.value AS name, r.base_material, r.icon, r.level, r.material_level, r.skill "
+                    "FROM recipes r "
+                    "JOIN strings p ON p.id = r.profession_id "
+                    "JOIN strings c ON c.id = r.category_id "
+                    "JOIN strings n ON n.id = r.name_id;");
+
+            transaction.commit();
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "[!] Failed to save sqlite file; caught exception:"
+                      << std::endl
+                      << std::endl
+                      << e.what()
+                      << std::endl;
+
+            std::filesystem::remove(path, ec);
+            return false;
+        }
+    }
+
+    /**
+     * Saves the parsed craft recipes to a normalized SQLite database file.
+     *
+     * Names are stored once in the strings table, keyed by their string table index, and referenced by id from the
+     * recipe and material tables. Recipes and materials are stored in WITHOUT ROWID tables keyed by their natural
+     * keys, with covering indices for the common profession, skill and material lookups.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_sqlite_normalized(const craft_extract::parse_result& result, const std::string& path)
+    {
+        return craft_extract::writers::write_sqlite_normalized(result.strings, craft_extract::writers::batches(result), path);
+    }
+
+    /**
+     * Appends the parsed craft recipes to an SQLite history database under the given version key.
+     *
+     * The database is created on first use and appended to afterwards. Names are stored once in the strings table
+     * and each distinct recipe row, identified by its fingerprint, is stored once in the recipes table; the
+     * recipes_versions table records which versions contain each recipe. Saving a version key that already exists
+     * replaces the contents of that version.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The history database file to append the parsed information to.
+     * @param {std::string} version - The version key to store the parsed information under.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_history(const craft_extract::parse_result& result, const std::string& path, const std::string& version)
+    {
+        if (version.empty())
+        {
+            std::cout << "[!] Error: A version key is required to save into a history database." << std::endl;
+            return false;
+        }
+
+        try
+        {
+            SQLite::Database db(path, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+
+            // The database holds previously saved versions; keep journaling enabled so a failed save is rolled back..
+            db.exec("PRAGMA synchronous = NORMAL;");
+            db.exec("PRAGMA temp_store = MEMORY;");
+            db.exec("PRAGMA cache_size = -65536;");
+
+            // Write all information within a single transaction..
+            SQLite::Transaction transaction(db);
+
+            // Prepare the various database tables..
+            db.exec("CREATE TABLE IF NOT EXISTS about_craft_extract (created_by TEXT, paypal TEXT, github TEXT, patreon TEXT, repo TEXT);");
+            db.exec("CREATE TABLE IF NOT EXISTS base_materials (id INTEGER PRIMARY KEY, name TEXT NOT NULL);");
+            db.exec("CREATE TABLE IF NOT EXISTS realms (id INTEGER PRIMARY KEY, name TEXT NOT NULL);");
+            db.exec("CREATE TABLE IF NOT EXISTS versions (id INTEGER PRIMARY KEY, name TEXT NOT NULL UNIQUE);");
+            db.exec("CREATE TABLE IF NOT EXISTS strings (id INTEGER PRIMARY KEY, value TEXT NOT NULL UNIQUE);");
+            db.exec("CREATE TABLE IF NOT EXISTS recipes ("
+                    "row_id INTEGER PRIMARY KEY, "
+                    "fingerprint INTEGER NOT NULL UNIQUE, "
+                    "realm_id INTEGER NOT NULL REFERENCES realms (id), "
+                    "profession_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "category_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "id INTEGER NOT NULL, "
+                    "name_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "base_material INTEGER NOT NULL REFERENCES base_materials (id), "
+                    "icon INTEGER NOT NULL, "
+                    "level INTEGER NOT NULL, "
+                    "material_level INTEGER NOT NULL, "
+                    "skill INTEGER NOT NULL);");
+            db.exec("CREATE TABLE IF NOT EXISTS recipes_materials ("
+                    "row_id INTEGER NOT NULL REFERENCES recipes (row_id), "
+                    "slot INTEGER NOT NULL, "
+                    "name_id INTEGER NOT NULL REFERENCES strings (id), "
+                    "base_material INTEGER NOT NULL REFERENCES base_materials (id), "
+                    "count INTEGER NOT NULL, "
+                    "PRIMARY KEY (row_id, slot)) WITHOUT ROWID;");
+            db.exec("CREATE TABLE IF NOT EXISTS recipes_versions ("
+                    "version_id INTEGER NOT NULL REFERENCES versions (id), "
+                    "row_id INTEGER NOT NULL REFERENCES recipes (row_id), "
+                    "PRIMARY KEY (version_id, row_id)) WITHOUT ROWID;");
+            db.exec("CREATE INDEX IF NOT EXISTS recipes_by_id ON recipes (realm_id, id);");
+            db.exec("CREATE INDEX IF NOT EXISTS recipes_versions_by_row ON recipes_versions (row_id, version_id);");
+            db.exec("CREATE VIEW IF NOT EXISTS recipes_history AS "
+                    "SELECT v.name AS version, r.realm_id, r.id, p.value AS profession, c.value AS category, n.value AS name, r.base_material, r.icon, r.level, r.material_level, r.skill, r.row_id "
+                    "FROM recipes_versions rv "
+                    "JOIN versions v ON v.id = rv.version_id "
+                    "JOIN recipes r ON r.row_id = rv.row_id "
+                    "JOIN strings p ON p.id = r.profession_id "
+                    "JOIN strings c ON c.id = r.category_id "
+                    "JOIN strings n ON n.id = r.name_id;");
+
+            // Write the static information on first use..
+            if (db.execAndGet("SELECT COUNT(*) FROM about_craft_extract;").getInt() == 0)
+            {
+                db.exec("INSERT INTO about_craft_extract VALUES('atom0s', 'https://paypal.me/atom0s', 'https://github.com/sponsors/atom0s', 'https://patreon.com/atom0s', 'https://github.com/atom0s/craft_extract');");
+
+                SQLite::Statement insert_base_material(db, "INSERT INTO base_materials VALUES(?, ?);");
+                for (auto x = 0u; x < base_materials.size(); x++)
+                {
+                    insert_base_material.bind(1, x);
+                    insert_base_material.bind(2, base_materials[x]);
+                    insert_base_material.exec();
+                    insert_base_material.reset();
+                }
+
+                SQLite::Statement insert_realm(db, "INSERT INTO realms VALUES(?, ?);");
+                for (auto x = 0u; x < realm_names.size(); x++)
+                {
+                    insert_realm.bind(1, x);
+                    insert_realm.bind(2, realm_names[x]);
+                    insert_realm.exec();
+                    insert_realm.reset();
+                }
+            }
+
+            // Register the version, replacing its contents if it was saved before..
+            SQLite::Statement insert_version(db, "INSERT OR IGNORE INTO versions (name) VALUES(?);");
+            insert_version.bind(1, version);
+            insert_version.exec();
+
+            SQLite::Statement select_version(db, "SELECT id FROM versions WHERE name = ?;");
+            select_version.bind(1, version);
+            select_version.executeStep();
+            const auto version_id = select_version.getColumn(0).getInt64();
+
+            SQLite::Statement delete_version(db, "DELETE FROM recipes_versions WHERE version_id = ?;");
+            delete_version.bind(1, version_id);
+            const auto replaced = delete_version.exec() > 0;
+
+            // Resolves the database id of a string, storing the string on first use..
+            SQLite::Statement insert_string(db, "INSERT OR IGNORE INTO strings (value) VALUES(?);");
+            SQLite::Statement select_string(db, "SELECT id FROM strings WHERE value = ?;");
+            std::vector<int64_t> string_ids(result.strings.size(), -1);
+
+            const auto string_id = [&](const uint32_t index) -> int64_t {
+                auto& id = string_ids[index];
+                if (id != -1)
+                    return id;
+
+                const auto value = result.strings.str(index);
+
+                insert_string.bind(1, value);
+                insert_string.exec();
+                insert_string.reset();
+
+                select_string.bind(1, value);
+                select_string.executeStep();
+                id = select_string.getColumn(0).getInt64();
+                select_string.reset();
+
+                return id;
+            };
+
+            // Write the recipes information.. (Recipes already stored by an earlier version are only linked.)
+            SQLite::Statement select_recipe(db, "SELECT row_id FROM recipes WHERE fingerprint = ?;");
+            SQLite::Statement insert_recipe(db, "INSERT INTO recipes (fingerprint, realm_id, profession_id, category_id, id, name_id, base_material, icon, level, material_level, skill) VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
+            SQLite::Statement insert_material(db, "INSERT INTO recipes_materials VALUES(?, ?, ?, ?, ?);");
+            SQLite::Statement insert_link(db, "INSERT OR IGNORE INTO recipes_versions VALUES(?, ?);");
+
+            for (auto iter = result.crafts.begin(), iterend = result.crafts.end(); iter != iterend; ++iter)
+            {
+                for (auto riter = iter->second.begin(), riterend = iter->second.end(); riter != riterend; ++riter)
+                {
+                    const auto fingerprint = static_cast<int64_t>(craft_extract::fingerprint(result, *riter));
+
+                    int64_t row_id = 0;
+
+                    select_recipe.bind(1, fingerprint);
+                    if (select_recipe.executeStep())
+                        row_id = select_recipe.getColumn(0).getInt64();
+                    select_recipe.reset();
+
+                    if (row_id == 0)
+                    {
+                        insert_recipe.bind(1, fingerprint);
+                        insert_recipe.bind(2, iter->first);
+                        insert_recipe.bind(3, string_id(riter->name_index_profession));
+                        insert_recipe.bind(4, string_id(riter->name_index_category));
+                        insert_recipe.bind(5, riter->id);
+                        insert_recipe.bind(6, string_id(riter->name_index_recipe));
+                        insert_recipe.bind(7, riter->base_material);
+                        insert_recipe.bind(8, riter->icon);
+                        insert_recipe.bind(9, riter->level);
+                        insert_recipe.bind(10, riter->material_level);
+                        insert_recipe.bind(11, riter->skill);
+                        insert_recipe.exec();
+                        insert_recipe.reset();
+
+                        row_id = db.getLastInsertRowid();
+
+                        for (auto m = 0u; m < riter->materials.size(); m++)
+                        {
+                            const auto& mat = riter->materials[m];
+
+                            insert_material.bind(1, row_id);
+                            insert_material.bind(2, m);
+                            insert_material.bind(3, string_id(mat.name_index));
+                            insert_material.bind(4, mat.base_material);
+                            insert_material.bind(5, mat.count);
+                            insert_material.exec();
+                            insert_material.reset();
+                        }
+                    }
+
+                    insert_link.bind(1, version_id);
+                    insert_link.bind(2, row_id);
+                    insert_link.exec();
+                    insert_link.reset();
+                }
+            }
+
+            // Remove recipes no longer referenced by any version after replacing a version..
+            if (replaced)
+            {
+                db.exec("DELETE FROM recipes_materials WHERE row_id NOT IN (SELECT row_id FROM recipes_versions);");
+                db.exec("DELETE FROM recipes WHERE row_id NOT IN (SELECT row_id FROM recipes_versions);");
+            }
+
+            transaction.commit();
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "[!] Failed to save sqlite file; caught exception:"
+                      << std::endl
+                      << std::endl
+                      << e.what()
+                      << std::endl;
+
+            return false;
+        }
+    }
+
+    /**
+     * Saves the parsed craft recipes to a plain-text file.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save_text(const craft_extract::parse_result& result, const std::string& path)
+    {
+        // Open the output file for writing..
+        std::ofstream ofs(path);
+        if (!ofs.is_open())
+        {
+            std::cout << "[!] Failed to open output file for writing!" << std::endl;
+            return false;
+        }
+
+        // Write the credits information..
+        ofs << "//" << std::endl
+            << "// File generated using craft_exporter by atom0s." << std::endl
+            << "//" << std::endl
+            << "// Contact  : https://atom0s.com/" << std::endl
+            << "// Contact  : https://twitter.com/atom0s" << std::endl
+            << "// Contact  : https://discord.gg/UmXNvjq - atom0s#0001" << std::endl
+            << "// Donations: https://www.paypal.me/atom0s" << std::endl
+            << "// Donations: https://github.com/sponsors/atom0s" << std::endl
+            << "// Donations: https://patreon.com/atom0s" << std::endl
+            << "//" << std::endl
+            << std::endl;
+
+        std::size_t total_recipes = 0;
+        for (const auto& r : result.crafts)
+            total_recipes += r.second.size();
+
+        ofs << "//" << std::endl
+            << std::format("// Total Recipes: {}", total_recipes) << std::endl;
+
+        for (const auto& r : result.crafts)
+            ofs << std::format("//   - {}: {}", realm_names[r.first], r.second.size()) << std::endl;
+
+        ofs << "//" << std::endl
+            << std::endl;
+
+        // Write the recipe information..
+        for (auto iter = result.crafts.begin(), iterend = result.crafts.end(); iter != iterend; ++iter)
+        {
+            ofs << std::format("REALM: {}", realm_names[iter->first])
+                << std::endl
+                << std::endl;
+
+            for (auto riter = iter->second.begin(), riterend = iter->second.end(); riter != riterend; ++riter)
+            {
+                std::stringstream ss;
+
+                ss << std::format("    {} - {} - {} - ",
+                    realm_names[riter->name_index_realm],
+                    result.strings[riter->name_index_profession],
+                    result.strings[riter->name_index_category]);
+
+                if (const auto bmaterial = craft_extract::base_material_name(riter->base_material); bmaterial.size() > 0)
+                    ss << bmaterial << " ";
+
+                ss << std::format("{} (MLv. {}) [Id: {}][Level: {}][Icon: {}][Skill: {}]",
+                          result.strings[riter->name_index_recipe],
+                          riter->material_level,
+                          riter->id,
+                          riter->level,
+                          riter->icon,
+                          riter->skill)
+                   << std::endl;
+
+                for (const auto& m : riter->materials)
+                {
+                    ss << std::format("      - {}x ", m.count);
+
+                    if (const auto bmaterial = craft_extract::base_material_name(m.base_material); bmaterial.size() > 0)
+                        ss << bmaterial << " ";
+
+                    ss << std::format("{}", result.strings[m.name_index])
+                       << std::endl;
+                }
+
+                ofs << ss.str() << std::endl;
+            }
+
+            ofs << std::endl;
+        }
+
+        ofs.close();
+
+        return true;
+    }
+
+    /**
+     * Returns the default file extension used for the given output mode.
+     *
+     * Every mode has its own extension, so the output files of several modes sharing a base path never collide.
+     *
+     * @param {output_mode} mode - The output file format.
+     * @return {const char*} The file extension, including the leading period.
+     */
+    inline const char* extension(const craft_extract::output_mode mode)
+    {
+        switch (mode)
+        {
+            case craft_extract::output_mode::none:
+                return "";
+            case craft_extract::output_mode::csv:
+                return ".csv";
+            case craft_extract::output_mode::json:
+                return ".json";
+            case craft_extract::output_mode::sqlite:
+                return ".sqlite";
+            case craft_extract::output_mode::sqlite_normalized:
+                return ".normalized.sqlite";
+            case craft_extract::output_mode::history:
+                return ".history.sqlite";
+            case craft_extract::output_mode::text:
+                return ".txt";
+            case craft_extract::output_mode::snapshot:
+                return ".crfx";
+        }
+
+        return "";
+    }
+
+    /**
+     * Saves the parsed craft recipe information to the desired output file.
+     *
+     * @param {parse_result} result - The parsed craft information to save.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @param {output_mode} mode - The output file format to use when saving.
+     * @param {save_options} options - The saving options.
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool save(const craft_extract::parse_result& result, const std::string& path, const craft_extract::output_mode mode, const craft_extract::save_options& options)
+    {
+        switch (mode)
+        {
+            case craft_extract::output_mode::none:
+                return false;
+            case craft_extract::output_mode::csv:
+                return save_csv(result, path);
+            case craft_extract::output_mode::json:
+                return save_json(result, path);
+            case craft_extract::output_mode::sqlite:
+                return save_sqlite(result, path);
+            case craft_extract::output_mode::sqlite_normalized:
+                return save_sqlite_normalized(result, path);
+            case craft_extract::output_mode::history:
+                return save_history(result, path, options.version);
+            case craft_extract::output_mode::text:
+                return save_text(result, path);
+            case craft_extract::output_mode::snapshot:
+                return craft_extract::snapshot::save(result, path);
+        }
+
+        return false;
+    }
+
+    /**
+     * Returns if the given output mode can be written while its input file is still being parsed.
+     *
+     * @param {output_mode} mode - The output file format.
+     * @return {bool} True if the mode can be streamed, false otherwise.
+     */
+    inline bool streamable(const craft_extract::output_mode mode)
+    {
+        return mode == craft_extract::output_mode::csv || mode == craft_extract::output_mode::sqlite || mode == craft_extract::output_mode::sqlite_normalized;
+    }
+
+    /**
+     * Writes the craft recipe batches received from the given queue to the desired output file.
+     *
+     * The queue is drained until it is closed. The string table may still be loading when writing starts; it is only
+     * read once a batch has been received, or once the queue has been closed.
+     *
+     * @param {string_table} strings - The string table of the recipes.
+     * @param {craft_queue} queue - The queue to receive the recipe batches from.
+     * @param {std::string} path - The output file to store the parsed information.
+     * @param {output_mode} mode - The output file format to use when saving. (Must be streamable.)
+     * @return {bool} True on success, false otherwise.
+     */
+    inline bool stream(const craft_extract::string_table& strings, craft_extract::craft_queue& queue, const std::string& path, const craft_extract::output_mode mode)
+    {
+        const auto source = [&queue](auto&& fn) {
+            craft_extract::craftbatch_t batch;
+            while (queue.pop(batch))
+                fn(batch.realm, std::span<const craft_extract::craft_t>(batch.crafts));
+        };
+
+        switch (mode)
+        {
+            case craft_extract::output_mode::csv:
+                return write_csv(strings, source, path);
+            case craft_extract::output_mode::sqlite:
+                return write_sqlite(strings, source, path);
+            case craft_extract::output_mode::sqlite_normalized:
+                return write_sqlite_normalized(strings, source, path);
+            default:
+                break;
+        }
+
+        return false;
+    }
+
+} // namespace craft_extract::writers
+
+#endif // CRAFT_EXTRACT_WRITERS_HPP
@@ -0,0 +1,137 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_extract.h"
+#include "craft_file.hpp"
+#include "loader.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+
+    const auto dir = tests::workdir("capi");
+
+    /**
+     * Returns the given C API string as a string view.
+     */
+    std::string_view view(const craft_extract_string_t& str)
+    {
+        return std::string_view(str.data, str.size);
+    }
+
+    /**
+     * Returns the fields of the given C API recipe as a string, matching tests::describe.
+     */
+    std::string describe(const craft_extract_recipe_t& recipe)
+    {
+        auto str = std::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+            recipe.realm,
+            view(recipe.profession),
+            view(recipe.category),
+            view(recipe.name),
+            recipe.base_material,
+            recipe.icon,
+            recipe.id,
+            recipe.level,
+            recipe.material_level,
+            recipe.skill);
+
+        for (auto x = 0u; x < recipe.material_count; x++)
+            str += std::format("|{}x{}:{}", recipe.materials[x].count, view(recipe.materials[x].name), recipe.materials[x].base_material);
+
+        return str;
+    }
+
+    void test_parse(void)
+    {
+        const auto path = (dir / "parse.crf").string();
+        CHECK(tests::write<v66>(path, tests::sample(3, 4)));
+
+        craft_extract::parse_result expected;
+        CHECK(craft_extract::load(path, {}, expected));
+
+        craft_extract_file_t* file = nullptr;
+        CHECK(craft_extract_parse(path.c_str(), nullptr, &file) == 1 && file != nullptr);
+        CHECK(craft_extract_count(file) == 3 * (3 * 3 * 4 + 1));
+
+        std::vector<std::string> recipes;
+        craft_extract_recipe_t recipe{};
+        for (size_t x = 0; craft_extract_recipe(file, x, &recipe); x++)
+            recipes.push_back(describe(recipe));
+
+        CHECK(recipes == tests::describe(expected));
+        CHECK(view(recipe.realm_name) == "Hibernia");
+
+        CHECK(craft_extract_write(file, (dir / "parse.csv").string().c_str(), CRAFT_EXTRACT_MODE_CSV, nullptr) == 1);
+        CHECK(craft_extract_write(file, (dir / "parse.crfx").string().c_str(), CRAFT_EXTRACT_MODE_SNAPSHOT, nullptr) == 1);
+        CHECK(craft_extract_write(file, (dir / "parse.history.sqlite").string().c_str(), CRAFT_EXTRACT_MODE_HISTORY, nullptr) == 0);
+        CHECK(std::filesystem::is_regular_file(dir / "parse.csv"));
+
+        craft_extract_free(file);
+
+        CHECK(craft_extract_parse((dir / "missing.crf").string().c_str(), nullptr, &file) == 0 && file == nullptr);
+    }
+
+    void test_filtered(void)
+    {
+        const auto path = (dir / "filtered.crf").string();
+        CHECK(tests::write<v66>(path, tests::sample(3, 4)));
+
+        craft_extract_filter_t filter{};
+        craft_extract_filter_init(&filter);
+        filter.realm      = 1;
+        filter.profession = "Tailoring";
+
+        craft_extract_file_t* file = nullptr;
+        CHECK(craft_extract_parse(path.c_str(), &filter, &file) == 1);
+        CHECK(craft_extract_count(file) == 3 * 4 + 1);
+
+        // Snapshots of filtered parses are refused..
+        CHECK(craft_extract_write(file, (dir / "filtered.crfx").string().c_str(), CRAFT_EXTRACT_MODE_SNAPSHOT, nullptr) == 0);
+        craft_extract_free(file);
+
+        // The lazy reader applies the same filters..
+        craft_extract_reader_t* reader = nullptr;
+        CHECK(craft_extract_open(path.c_str(), &filter, &reader) == 1);
+
+        auto count = 0u;
+        craft_extract_recipe_t recipe{};
+        while (craft_extract_next(reader, &recipe))
+        {
+            CHECK(recipe.realm == 1 && view(recipe.profession) == "Tailoring");
+            count++;
+        }
+
+        CHECK(count == 3 * 4 + 1);
+        craft_extract_close(reader);
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("parse", test_parse);
+    tests::run("filtered", test_filtered);
+
+    return tests::finish();
+}
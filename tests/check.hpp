@@ -0,0 +1,108 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_TESTS_CHECK_HPP
+#define CRAFT_EXTRACT_TESTS_CHECK_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+
+/**
+ * Checks the given condition, reporting it as a failure when it does not hold. (The test continues either way.)
+ */
+#define CHECK(expr) craft_extract::tests::check((expr), #expr, __FILE__, __LINE__)
+
+namespace craft_extract::tests
+{
+    /**
+     * The number of failed checks of the current test executable.
+     */
+    inline std::size_t failures = 0;
+
+    /**
+     * Records the result of a check.
+     *
+     * @param {bool} result - The check result.
+     * @param {char*} expr - The checked expression.
+     * @param {char*} file - The source file of the check.
+     * @param {int32_t} line - The source line of the check.
+     * @return {bool} The check result.
+     */
+    inline bool check(const bool result, const char* expr, const char* file, const int32_t line)
+    {
+        if (!result)
+        {
+            std::cout << std::format("[!] Check failed: {} ({}:{})", expr, file, line) << std::endl;
+            failures++;
+        }
+
+        return result;
+    }
+
+    /**
+     * Runs the given test, reporting its name.
+     *
+     * @param {char*} name - The test name.
+     * @param {Fn} fn - The test function.
+     */
+    template<typename Fn>
+    void run(const char* name, Fn&& fn)
+    {
+        const auto before = failures;
+        fn();
+
+        std::cout << std::format("[{}] {}", failures == before ? "PASS" : "FAIL", name) << std::endl;
+    }
+
+    /**
+     * Returns the exit code of the current test executable.
+     *
+     * @return {int32_t} 0 if every check passed, 1 otherwise.
+     */
+    inline int32_t finish(void)
+    {
+        if (failures > 0)
+            std::cout << std::format("[!] {} check(s) failed.", failures) << std::endl;
+
+        return failures == 0 ? 0 : 1;
+    }
+
+    /**
+     * Returns a fresh, empty working directory for the given test executable.
+     *
+     * @param {std::string} name - The test executable name.
+     * @return {std::filesystem::path} The working directory.
+     */
+    inline std::filesystem::path workdir(const std::string& name)
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "craft_extract_tests" / name;
+
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+        std::filesystem::create_directories(dir, ec);
+
+        return dir;
+    }
+
+} // namespace craft_extract::tests
+
+#endif // CRAFT_EXTRACT_TESTS_CHECK_HPP
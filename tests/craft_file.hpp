@@ -0,0 +1,333 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRAFT_EXTRACT_TESTS_CRAFT_FILE_HPP
+#define CRAFT_EXTRACT_TESTS_CRAFT_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "defines.hpp"
+#include "crafts.hpp"
+#include "v66.hpp"
+#include "v67.hpp"
+
+/**
+ * Synthetic craft file builder.
+ *
+ * Describes the craft information of a file independently of its layout and writes it out in the binary layout of
+ * any supported header version, so the same information can be parsed from each layout and compared.
+ */
+namespace craft_extract::tests
+{
+    /**
+     * Craft File Description Structure Definitions
+     */
+
+    struct material_spec
+    {
+        uint32_t name_index;
+        uint16_t count;
+        uint16_t base_material;
+    };
+
+    struct recipe_spec
+    {
+        uint32_t id;
+        uint32_t name_index;
+        uint16_t base_material;
+        uint16_t icon;
+        uint16_t skill;
+        uint16_t material_level;
+        uint16_t level;
+        std::vector<craft_extract::tests::material_spec> materials;
+    };
+
+    struct category_spec
+    {
+        uint32_t name_index;
+        std::vector<uint16_t> recipes; // Indices into the realms recipes, starting at 1. (0 is the unused entry.)
+    };
+
+    struct profession_spec
+    {
+        uint16_t name_index;
+        std::vector<uint16_t> categories; // Indices into the realms categories, starting at 1. (0 is the unused entry.)
+    };
+
+    struct realm_spec
+    {
+        std::vector<craft_extract::tests::recipe_spec> recipes;
+        std::vector<craft_extract::tests::category_spec> categories;
+        std::vector<craft_extract::tests::profession_spec> professions;
+    };
+
+    struct file_spec
+    {
+        std::vector<std::string> strings;
+        std::array<craft_extract::tests::realm_spec, 3> realms;
+    };
+
+    /**
+     * Builds the binary craft file of the given description, in the given layout.
+     *
+     * @param {file_spec} spec - The craft file description.
+     * @return {std::vector<uint8_t>} The craft file contents.
+     */
+    template<typename Layout>
+    std::vector<uint8_t> build(const craft_extract::tests::file_spec& spec)
+    {
+        std::vector<uint8_t> data(sizeof(typename Layout::header_t), 0);
+
+        const auto append = [&data](const void* src, const std::size_t size) {
+            const auto bytes = static_cast<const uint8_t*>(src);
+            data.insert(data.end(), bytes, bytes + size);
+        };
+
+        typename Layout::header_t header{};
+        header.version = Layout::version;
+
+        // Write the strings block and its index table..
+        std::string block;
+        std::vector<uint32_t> index;
+        for (const auto& str : spec.strings)
+        {
+            index.push_back(static_cast<uint32_t>(block.size()));
+            block.append(str);
+            block.push_back('\0');
+        }
+        block.append(2, '\0');
+
+        header.strings_block_size = static_cast<uint32_t>(block.size());
+        header.strings_count      = static_cast<uint32_t>(index.size());
+        header.strings_offset     = 0;
+
+        append(block.data(), block.size());
+        append(index.data(), index.size() * sizeof(uint32_t));
+
+        // Write the tables of each realm..
+        for (auto r = 0u; r < spec.realms.size(); r++)
+        {
+            const auto& realm = spec.realms[r];
+
+            std::vector<typename Layout::recipe_t> recipes(realm.recipes.size() + 1);
+            for (auto x = 0u; x < realm.recipes.size(); x++)
+            {
+                const auto& src = realm.recipes[x];
+                auto& dst       = recipes[x + 1];
+
+                dst.id             = src.id;
+                dst.name_index     = src.name_index;
+                dst.base_material  = src.base_material;
+                dst.icon           = src.icon;
+                dst.skill          = src.skill;
+                dst.material_level = src.material_level;
+                dst.level          = src.level;
+
+                for (auto m = 0u; m < src.materials.size(); m++)
+                {
+                    dst.materials[m].name_index    = src.materials[m].name_index;
+                    dst.materials[m].count         = src.materials[m].count;
+                    dst.materials[m].base_material = src.materials[m].base_material;
+                }
+            }
+
+            std::vector<typename Layout::category_t> categories(realm.categories.size() + 1);
+            for (auto x = 0u; x < realm.categories.size(); x++)
+            {
+                categories[x + 1].name_index = realm.categories[x].name_index;
+                std::ranges::copy(realm.categories[x].recipes, categories[x + 1].recipe_ids);
+            }
+
+            typename Layout::professions_t professions{};
+            for (auto x = 0u; x < realm.professions.size(); x++)
+            {
+                auto& dst = professions.professions[x];
+
+                dst.name_index = realm.professions[x].name_index;
+                dst.index      = static_cast<uint16_t>(x);
+                std::ranges::copy(realm.professions[x].categories, dst.index_list + Layout::first_category);
+            }
+
+            auto& info                  = header.realms[r];
+            info.recipe_count           = static_cast<uint32_t>(recipes.size());
+            info.category_count         = static_cast<uint32_t>(categories.size());
+            info.recipe_list_offset     = static_cast<uint32_t>(data.size());
+            append(recipes.data(), recipes.size() * sizeof(typename Layout::recipe_t));
+            info.category_list_offset   = static_cast<uint32_t>(data.size());
+            append(categories.data(), categories.size() * sizeof(typename Layout::category_t));
+            info.profession_list_offset = static_cast<uint32_t>(data.size());
+            append(&professions, sizeof(professions));
+        }
+
+        std::memcpy(data.data(), &header, sizeof(header));
+        return data;
+    }
+
+    /**
+     * Writes the binary craft file of the given description, in the given layout.
+     *
+     * @param {std::filesystem::path} path - The craft file to write.
+     * @param {file_spec} spec - The craft file description.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Layout>
+    bool write(const std::filesystem::path& path, const craft_extract::tests::file_spec& spec)
+    {
+        const auto data = craft_extract::tests::build<Layout>(spec);
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        ofs.close();
+
+        return !ofs.fail();
+    }
+
+    /**
+     * Returns a deterministic craft file description of the given size.
+     *
+     * Each realm holds three professions of the given number of categories, each listing the given number of
+     * recipes. The last category of each realm also lists the first recipe of the realm, so one recipe is listed
+     * twice with identical information.
+     *
+     * @param {uint32_t} categories - The number of categories of each profession. (At most 200.)
+     * @param {uint32_t} recipes - The number of recipes of each category. (At most 49.)
+     * @param {uint32_t} seed - Varies the recipe information.
+     * @return {file_spec} The craft file description.
+     */
+    inline craft_extract::tests::file_spec sample(const uint32_t categories, const uint32_t recipes, const uint32_t seed = 0)
+    {
+        craft_extract::tests::file_spec spec;
+        spec.strings.emplace_back();
+
+        const auto string = [&spec](std::string str) {
+            spec.strings.push_back(std::move(str));
+            return static_cast<uint32_t>(spec.strings.size() - 1);
+        };
+
+        const std::array<uint32_t, 3> professions{string("Weaponcraft"), string("Armorcraft"), string("Tailoring")};
+
+        std::vector<uint32_t> materials;
+        for (auto x = 0u; x < 16; x++)
+            materials.push_back(string(std::format("Material {}", x)));
+
+        std::vector<uint32_t> names;
+        for (auto x = 0u; x < 64; x++)
+            names.push_back(string(std::format("Recipe {}", x)));
+
+        for (auto r = 0u; r < spec.realms.size(); r++)
+        {
+            auto& realm = spec.realms[r];
+
+            for (auto p = 0u; p < professions.size(); p++)
+            {
+                craft_extract::tests::profession_spec profession{static_cast<uint16_t>(professions[p]), {}};
+
+                for (auto c = 0u; c < categories; c++)
+                {
+                    craft_extract::tests::category_spec category{string(std::format("Category {}-{}-{}", r, p, c)), {}};
+
+                    for (auto i = 0u; i < recipes; i++)
+                    {
+                        const auto n = static_cast<uint32_t>(realm.recipes.size());
+
+                        craft_extract::tests::recipe_spec recipe{};
+                        recipe.id             = r * 100000 + n + 1;
+                        recipe.name_index     = names[(n + seed) % names.size()];
+                        recipe.base_material  = static_cast<uint16_t>((n + seed) % 50);
+                        recipe.icon           = static_cast<uint16_t>(n % 997);
+                        recipe.skill          = static_cast<uint16_t>((n * 7 + seed) % 1100);
+                        recipe.material_level = static_cast<uint16_t>(n % 10);
+                        recipe.level          = static_cast<uint16_t>(n % 51);
+
+                        for (auto m = 0u; m <= n % 4; m++)
+                            recipe.materials.push_back({materials[(n + m) % materials.size()], static_cast<uint16_t>(m + 1), static_cast<uint16_t>((n + m) % 120)});
+
+                        realm.recipes.push_back(std::move(recipe));
+                        category.recipes.push_back(static_cast<uint16_t>(realm.recipes.size()));
+                    }
+
+                    realm.categories.push_back(std::move(category));
+                    profession.categories.push_back(static_cast<uint16_t>(realm.categories.size()));
+                }
+
+                realm.professions.push_back(std::move(profession));
+            }
+
+            if (!realm.categories.empty())
+                realm.categories.back().recipes.push_back(1);
+        }
+
+        return spec;
+    }
+
+    /**
+     * Returns every field of the given craft recipe as a string, with its names resolved.
+     *
+     * Used to compare recipes parsed from different files, whose string indices may differ.
+     *
+     * @param {Strings} strings - Resolves a name index of the recipe to its string.
+     * @param {craft_t} craft - The craft recipe.
+     * @return {std::string} The recipe fields.
+     */
+    template<typename Strings>
+    std::string describe(const Strings& strings, const craft_extract::craft_t& craft)
+    {
+        auto str = std::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+            craft.name_index_realm,
+            strings(craft.name_index_profession),
+            strings(craft.name_index_category),
+            strings(craft.name_index_recipe),
+            craft.base_material,
+            craft.icon,
+            craft.id,
+            craft.level,
+            craft.material_level,
+            craft.skill);
+
+        for (const auto& m : craft.materials)
+            str += std::format("|{}x{}:{}", m.count, strings(m.name_index), m.base_material);
+
+        return str;
+    }
+
+    /**
+     * Returns every recipe of the given parsed craft information, as described by describe, in realm order.
+     *
+     * @param {parse_result} result - The parsed craft information.
+     * @return {std::vector<std::string>} The recipe descriptions.
+     */
+    inline std::vector<std::string> describe(const craft_extract::parse_result& result)
+    {
+        const auto strings = [&result](const uint32_t index) { return result.strings[index]; };
+
+        std::vector<std::string> crafts;
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+                crafts.push_back(craft_extract::tests::describe(strings, craft));
+        }
+
+        return crafts;
+    }
+
+} // namespace craft_extract::tests
+
+#endif // CRAFT_EXTRACT_TESTS_CRAFT_FILE_HPP
@@ -0,0 +1,152 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "diff.hpp"
+#include "loader.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+    using v67 = craft_extract::parser::v67::layout_t;
+
+    const auto dir = tests::workdir("diff");
+
+    /**
+     * Writes the given craft file description in the given layout and parses it.
+     */
+    template<typename Layout>
+    bool parse(const std::string& name, const tests::file_spec& spec, craft_extract::parse_result& result)
+    {
+        const auto path = (dir / name).string();
+        return tests::write<Layout>(path, spec) && craft_extract::load(path, {}, result);
+    }
+
+    /**
+     * Returns the contents of the given file.
+     */
+    std::string read(const std::filesystem::path& path)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    void test_identical_files(void)
+    {
+        const auto spec = tests::sample(3, 5);
+
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+        CHECK(parse<v66>("old.crf", spec, lhs));
+        CHECK(parse<v67>("new.crf", spec, rhs));
+
+        // Files of different versions holding the same recipes have no differences..
+        craft_extract::diff::summary_t summary{};
+        CHECK(craft_extract::diff::compare(lhs, rhs, (dir / "identical.txt").string(), summary));
+
+        CHECK(summary.added == 0);
+        CHECK(summary.removed == 0);
+        CHECK(summary.changed == 0);
+        CHECK(summary.unchanged == 3 * 3 * 3 * 5);
+
+        const auto report = read(dir / "identical.txt");
+        CHECK(report.find("ADDED") == std::string::npos);
+        CHECK(report.find("CHANGED") == std::string::npos);
+        CHECK(report.find("REMOVED") == std::string::npos);
+    }
+
+    void test_changes(void)
+    {
+        const auto spec = tests::sample(3, 5);
+        auto changed    = spec;
+
+        // Change one recipe, remove one and add one..
+        changed.realms[0].recipes[4].skill++;
+        changed.realms[1].categories[0].recipes.erase(changed.realms[1].categories[0].recipes.begin() + 2);
+
+        auto added = changed.realms[2].recipes[0];
+        added.id   = 999999;
+        changed.realms[2].recipes.push_back(added);
+        changed.realms[2].categories[1].recipes.push_back(static_cast<uint16_t>(changed.realms[2].recipes.size()));
+
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+        CHECK(parse<v67>("old.crf", spec, lhs));
+        CHECK(parse<v67>("new.crf", changed, rhs));
+
+        craft_extract::diff::summary_t summary{};
+        CHECK(craft_extract::diff::compare(lhs, rhs, (dir / "changes.txt").string(), summary));
+
+        CHECK(summary.added == 1);
+        CHECK(summary.removed == 1);
+        CHECK(summary.changed == 1);
+        CHECK(summary.unchanged == 3 * 3 * 3 * 5 - 2);
+
+        const auto report = read(dir / "changes.txt");
+        CHECK(report.find("ADDED: Hibernia - Id: 999999") != std::string::npos);
+        CHECK(report.find(std::format("REMOVED: Midgard - Id: {}", spec.realms[1].recipes[2].id)) != std::string::npos);
+        CHECK(report.find(std::format("CHANGED: Albion - Id: {}", spec.realms[0].recipes[4].id)) != std::string::npos);
+
+        // The changed recipe is listed as removed from the old file and added to the new file..
+        const auto at = report.find("CHANGED:");
+        CHECK(at != std::string::npos && report.find("    - ", at) != std::string::npos && report.find("    + ", at) != std::string::npos);
+
+        // Comparing in the other direction swaps the added and removed recipes..
+        CHECK(craft_extract::diff::compare(rhs, lhs, (dir / "reverse.txt").string(), summary));
+        CHECK(summary.added == 1 && summary.removed == 1 && summary.changed == 1);
+    }
+
+    void test_listed_recipes(void)
+    {
+        const auto spec = tests::sample(2, 3);
+
+        // Listing a recipe once more in the same category, with identical information, is not a difference..
+        auto relisted = spec;
+        relisted.realms[0].categories[0].recipes.push_back(2);
+
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+        CHECK(parse<v67>("old.crf", spec, lhs));
+        CHECK(parse<v67>("new.crf", relisted, rhs));
+
+        craft_extract::diff::index_t index;
+        craft_extract::diff::index(rhs, index);
+        // The last category of each realm also lists the first recipe of the realm; a distinct entry of its group..
+        CHECK(index.groups.size() == 3 * 3 * 2 * 3);
+        CHECK(index.entries.size() == index.groups.size() + 3);
+
+        craft_extract::diff::summary_t summary{};
+        CHECK(craft_extract::diff::compare(lhs, rhs, (dir / "relisted.txt").string(), summary));
+        CHECK(summary.changed == 0 && summary.unchanged == 3 * 3 * 2 * 3);
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("identical_files", test_identical_files);
+    tests::run("changes", test_changes);
+    tests::run("listed_recipes", test_listed_recipes);
+
+    return tests::finish();
+}
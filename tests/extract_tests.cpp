@@ -0,0 +1,241 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "batch.hpp"
+#include "extract.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v67 = craft_extract::parser::v67::layout_t;
+
+    const auto dir = tests::workdir("extract");
+
+    /**
+     * Returns the contents of the given file.
+     */
+    std::string read(const std::filesystem::path& path)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Replaces the contents of the given file.
+     */
+    void overwrite(const std::filesystem::path& path, const std::string& contents)
+    {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << contents;
+    }
+
+    /**
+     * Returns the integer result of the given query.
+     */
+    int64_t query(const std::filesystem::path& path, const std::string& sql)
+    {
+        SQLite::Database db(path.string(), SQLite::OPEN_READONLY);
+        return db.execAndGet(sql).getInt64();
+    }
+
+    void test_pipeline(void)
+    {
+        // Large enough for each realm to be streamed in several batches..
+        const auto input = (dir / "pipeline.crf").string();
+        CHECK(tests::write<v67>(input, tests::sample(40, 40)));
+
+        craft_extract::save_options direct{};
+        direct.pipeline = false;
+
+        craft_extract::save_options pipelined{};
+        pipelined.pipeline = true;
+
+        const auto extract = [&input](const craft_extract::output_mode mode, const std::filesystem::path& output, const craft_extract::save_options& settings) {
+            return craft_extract::extract(input, {{mode, output.string()}}, {}, settings) == craft_extract::extract_result::extracted;
+        };
+
+        CHECK(extract(craft_extract::output_mode::csv, dir / "direct.csv", direct));
+        CHECK(extract(craft_extract::output_mode::csv, dir / "pipelined.csv", pipelined));
+        CHECK(read(dir / "direct.csv").size() > 0);
+        CHECK(read(dir / "direct.csv") == read(dir / "pipelined.csv"));
+
+        CHECK(extract(craft_extract::output_mode::sqlite, dir / "direct.sqlite", direct));
+        CHECK(extract(craft_extract::output_mode::sqlite, dir / "pipelined.sqlite", pipelined));
+        CHECK(extract(craft_extract::output_mode::sqlite_normalized, dir / "direct.sqlnorm.sqlite", direct));
+        CHECK(extract(craft_extract::output_mode::sqlite_normalized, dir / "pipelined.sqlnorm.sqlite", pipelined));
+
+        for (const auto& table : {"recipes", "recipes_materials"})
+        {
+            const auto sql = std::format("SELECT COUNT(*) FROM {}", table);
+
+            CHECK(query(dir / "direct.sqlite", sql) == query(dir / "pipelined.sqlite", sql));
+            CHECK(query(dir / "direct.sqlnorm.sqlite", sql) == query(dir / "pipelined.sqlnorm.sqlite", sql));
+        }
+
+        CHECK(query(dir / "direct.sqlite", "SELECT COUNT(*) FROM recipes") == 3 * (3 * 40 * 40 + 1));
+        CHECK(query(dir / "direct.sqlnorm.sqlite", "SELECT COUNT(*) FROM strings") == query(dir / "pipelined.sqlnorm.sqlite", "SELECT COUNT(*) FROM strings"));
+        CHECK(query(dir / "pipelined.sqlnorm.sqlite", "SELECT COUNT(*) FROM recipes_named") == query(dir / "pipelined.sqlnorm.sqlite", "SELECT COUNT(*) FROM recipes"));
+    }
+
+    void test_cache(void)
+    {
+        const auto input  = (dir / "cache.crf").string();
+        const auto output = dir / "cache.csv";
+        const auto spec   = tests::sample(2, 3);
+
+        CHECK(tests::write<v67>(input, spec));
+
+        const std::vector<craft_extract::target_t> targets{{craft_extract::output_mode::csv, output.string()}};
+
+        craft_extract::save_options settings{};
+        settings.cache = true;
+
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::extracted);
+        CHECK(std::filesystem::exists(craft_extract::cache::path(output.string())));
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::unchanged);
+
+        const auto expected = read(output);
+
+        // Output files modified since their extraction are written again..
+        overwrite(output, "junk");
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::extracted);
+        CHECK(read(output) == expected);
+
+        // ..including modifications that keep the output file size..
+        auto junk = expected;
+        std::ranges::fill(junk, '#');
+
+        const auto time = std::filesystem::last_write_time(output);
+        overwrite(output, junk);
+        std::filesystem::last_write_time(output, time - std::chrono::hours(1));
+
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::extracted);
+        CHECK(read(output) == expected);
+
+        // ..as are removed output files..
+        std::filesystem::remove(output);
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::extracted);
+        CHECK(craft_extract::extract(input, targets, {}, settings) == craft_extract::extract_result::unchanged);
+
+        // Changing the options or the input file invalidates the cache..
+        craft_extract::parse_options options{};
+        options.realm = 2;
+
+        CHECK(craft_extract::extract(input, targets, options, settings) == craft_extract::extract_result::extracted);
+        CHECK(craft_extract::extract(input, targets, options, settings) == craft_extract::extract_result::unchanged);
+
+        auto changed = spec;
+        changed.realms[2].recipes[1].level++;
+        CHECK(tests::write<v67>(input, changed));
+        CHECK(craft_extract::extract(input, targets, options, settings) == craft_extract::extract_result::extracted);
+
+        // Without caching, the input file is always extracted and no cache is left behind..
+        settings.cache = false;
+        CHECK(craft_extract::extract(input, targets, options, settings) == craft_extract::extract_result::extracted);
+        CHECK(!std::filesystem::exists(craft_extract::cache::path(output.string())));
+    }
+
+    /**
+     * Returns the output files of the given targets.
+     */
+    std::vector<std::string> outputs(const std::vector<craft_extract::target_t>& targets)
+    {
+        std::vector<std::string> paths;
+        for (const auto& target : targets)
+            paths.push_back(target.output);
+
+        return paths;
+    }
+
+    void test_targets(void)
+    {
+        using mode = craft_extract::output_mode;
+
+        // A single mode is saved to the output file as given..
+        CHECK(outputs(craft_extract::targets("crafts.dat", {mode::csv})) == std::vector<std::string>{"crafts.dat"});
+
+        // Several modes append their extensions, keeping dotted names intact..
+        CHECK(outputs(craft_extract::targets("export-1.127e", {mode::csv, mode::json})) == (std::vector<std::string>{"export-1.127e.csv", "export-1.127e.json"}));
+
+        // ..and replace a trailing mode extension, including the multi-part ones..
+        CHECK(outputs(craft_extract::targets("crafts.csv", {mode::csv, mode::text})) == (std::vector<std::string>{"crafts.csv", "crafts.txt"}));
+        CHECK(outputs(craft_extract::targets("v1.5.normalized.sqlite", {mode::sqlite_normalized, mode::csv, mode::sqlite})) == (std::vector<std::string>{"v1.5.normalized.sqlite", "v1.5.csv", "v1.5.sqlite"}));
+        CHECK(outputs(craft_extract::targets("v1.5.sqlite", {mode::sqlite_normalized, mode::sqlite})) == (std::vector<std::string>{"v1.5.normalized.sqlite", "v1.5.sqlite"}));
+
+        CHECK(craft_extract::base_path(".csv") == ".csv");
+    }
+
+    void test_batch(void)
+    {
+        namespace fs = std::filesystem;
+
+        const auto src = dir / "batch";
+        const auto out = dir / "batch_out";
+        fs::create_directories(src / "sub");
+
+        CHECK(tests::write<v67>(src / "v1.5.crf", tests::sample(1, 2)));
+        CHECK(tests::write<v67>(src / "sub" / "TDL.CRF", tests::sample(1, 3)));
+
+        const std::vector<craft_extract::output_mode> modes{craft_extract::output_mode::sqlite_normalized, craft_extract::output_mode::csv};
+
+        // Directories are scanned recursively, mirroring their layout..
+        std::vector<craft_extract::batch::job_t> jobs;
+        CHECK(craft_extract::batch::collect(src.string(), out.string(), modes, jobs));
+        CHECK(jobs.size() == 2);
+
+        craft_extract::save_options settings{};
+        CHECK(craft_extract::batch::run(jobs, 2, {}, settings) == 0);
+
+        for (const auto& name : {"v1.5.normalized.sqlite", "v1.5.csv", "sub/TDL.normalized.sqlite", "sub/TDL.csv"})
+            CHECK(fs::is_regular_file(out / name));
+
+        CHECK(!fs::exists(out / "v1.5.normalized.normalized.sqlite"));
+        CHECK(!fs::exists(out / "v1.5.normalized.csv"));
+
+        // Wildcard patterns ignore case..
+        CHECK(craft_extract::batch::matches("*.crf", "TDL.CRF"));
+        CHECK(craft_extract::batch::matches("t?l.*", "TDL.CRF"));
+        CHECK(!craft_extract::batch::matches("*.crf", "tdl.crfx"));
+
+        CHECK(craft_extract::batch::collect((src / "sub" / "*.crf").string(), out.string(), modes, jobs));
+        CHECK(jobs.size() == 1 && outputs(jobs[0].targets) == (std::vector<std::string>{(out / "TDL.normalized.sqlite").string(), (out / "TDL.csv").string()}));
+
+        // Manifest output paths are used as with --out..
+        const auto manifest = dir / "manifest.txt";
+        overwrite(manifest, std::format("# comment\n{}\tpatch.1.127e\n", (src / "v1.5.crf").string()));
+
+        CHECK(craft_extract::batch::collect(manifest.string(), out.string(), modes, jobs));
+        CHECK(jobs.size() == 1 && outputs(jobs[0].targets) == (std::vector<std::string>{(out / "patch.1.127e.normalized.sqlite").string(), (out / "patch.1.127e.csv").string()}));
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("pipeline", test_pipeline);
+    tests::run("cache", test_cache);
+    tests::run("targets", test_targets);
+    tests::run("batch", test_batch);
+
+    return tests::finish();
+}
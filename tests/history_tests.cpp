@@ -0,0 +1,119 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "loader.hpp"
+#include "writers.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+    using v67 = craft_extract::parser::v67::layout_t;
+
+    const auto dir = tests::workdir("history");
+
+    /**
+     * Writes the given craft file description in the given layout, parses it and appends it to the history database.
+     */
+    template<typename Layout>
+    bool append(const std::filesystem::path& db, const tests::file_spec& spec, const std::string& version)
+    {
+        const auto path = (dir / std::format("{}.crf", version)).string();
+
+        craft_extract::parse_result result;
+        return tests::write<Layout>(path, spec) && craft_extract::load(path, {}, result) && craft_extract::writers::save_history(result, db.string(), version);
+    }
+
+    /**
+     * Returns the integer result of the given query.
+     */
+    int64_t query(const std::filesystem::path& path, const std::string& sql)
+    {
+        SQLite::Database db(path.string(), SQLite::OPEN_READONLY);
+        return db.execAndGet(sql).getInt64();
+    }
+
+    void test_deduplication(void)
+    {
+        const auto db   = dir / "dedupe.history.sqlite";
+        const auto spec = tests::sample(2, 3);
+
+        // Every recipe is distinct; the relisted recipe of each realm is listed under another category..
+        const auto recipes = 3 * (3 * 2 * 3 + 1);
+
+        CHECK(append<v66>(db, spec, "1.0"));
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes;") == recipes);
+
+        const auto materials = query(db, "SELECT COUNT(*) FROM recipes_materials;");
+        const auto strings   = query(db, "SELECT COUNT(*) FROM strings;");
+
+        // A second version with the same recipes, from another layout, only links the stored rows..
+        CHECK(append<v67>(db, spec, "1.1"));
+        CHECK(query(db, "SELECT COUNT(*) FROM versions;") == 2);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes;") == recipes);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_materials;") == materials);
+        CHECK(query(db, "SELECT COUNT(*) FROM strings;") == strings);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_versions;") == 2 * recipes);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_history WHERE version = '1.1';") == recipes);
+
+        // A version changing a single recipe adds a single row..
+        auto changed = spec;
+        changed.realms[1].recipes[3].level++;
+
+        CHECK(append<v67>(db, changed, "1.2"));
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes;") == recipes + 1);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_history WHERE version = '1.2';") == recipes);
+        CHECK(query(db, std::format("SELECT COUNT(DISTINCT level) FROM recipes WHERE realm_id = 1 AND id = {};", spec.realms[1].recipes[3].id)) == 2);
+    }
+
+    void test_replace_version(void)
+    {
+        const auto db   = dir / "replace.history.sqlite";
+        const auto spec = tests::sample(2, 3);
+
+        auto changed = spec;
+        changed.realms[0].recipes[1].skill++;
+
+        const auto recipes = 3 * (3 * 2 * 3 + 1);
+
+        CHECK(append<v67>(db, spec, "1.0"));
+        CHECK(append<v67>(db, changed, "1.1"));
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes;") == recipes + 1);
+
+        // Saving an existing version again replaces it; rows no longer referenced by any version are removed..
+        CHECK(append<v67>(db, spec, "1.1"));
+        CHECK(query(db, "SELECT COUNT(*) FROM versions;") == 2);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes;") == recipes);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_versions;") == 2 * recipes);
+        CHECK(query(db, "SELECT COUNT(*) FROM recipes_materials WHERE row_id NOT IN (SELECT row_id FROM recipes);") == 0);
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("deduplication", test_deduplication);
+    tests::run("replace_version", test_replace_version);
+
+    return tests::finish();
+}
@@ -0,0 +1,220 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "craft_file.hpp"
+#include "loader.hpp"
+
+/**
+ * Craft file parsing benchmark.
+ *
+ * Times the parser against a reference implementation of the original traversal, which looked up the per-realm
+ * tables through std::map on every access and copied each recipe by value, and ensures both produce the same
+ * recipes. Usage:
+ *
+ *      parse_benchmark [iterations] [file]
+ *
+ * When no file is given, a synthetic v66 file of 3 realms x 3 professions x 40 categories x 40 recipes is used.
+ */
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+
+    /**
+     * Parses the given file with the original map based traversal.
+     *
+     * @param {byte_span} data - View over the mapped input file.
+     * @param {parse_result} result - The result to store the parsed information into.
+     * @return {bool} True on success, false otherwise.
+     */
+    template<typename Layout>
+    bool reference_parse(const craft_extract::byte_span& data, craft_extract::parse_result& result)
+    {
+        result.clear();
+
+        const auto& header = *data.at<typename Layout::header_t>(0);
+        if (!result.strings.load(data, sizeof(typename Layout::header_t) + header.strings_offset, header.strings_block_size, header.strings_count))
+            return false;
+
+        std::map<uint32_t, const typename Layout::professions_t*> professions;
+        std::map<uint32_t, std::span<const typename Layout::recipe_t>> recipes;
+        std::map<uint32_t, std::span<const typename Layout::category_t>> categories;
+
+        for (auto realm = 0u; realm < 3; realm++)
+        {
+            const auto& rdata = header.realms[realm];
+
+            professions[realm] = data.at<typename Layout::professions_t>(rdata.profession_list_offset);
+            recipes[realm]     = data.array<typename Layout::recipe_t>(rdata.recipe_list_offset, rdata.recipe_count);
+            categories[realm]  = data.array<typename Layout::category_t>(rdata.category_list_offset, rdata.category_count);
+        }
+
+        for (auto r = 0u; r < 3; r++)
+        {
+            for (auto p = 0u; p < std::extent_v<decltype(Layout::professions_t::professions)>; p++)
+            {
+                if (p != 0 && professions[r]->professions[p].index == 0)
+                    continue;
+
+                const auto p_nindex = professions[r]->professions[p].name_index;
+                if (p_nindex == 0)
+                    continue;
+
+                for (auto i = Layout::first_category; i < std::extent_v<decltype(Layout::profession_t::index_list)>; i++)
+                {
+                    const auto pidx = professions[r]->professions[p].index_list[i];
+                    if (pidx == 0)
+                        continue;
+
+                    const auto cidx = categories[r][pidx].name_index;
+                    if (cidx == 0)
+                        continue;
+
+                    for (auto c = 0u; c < std::extent_v<decltype(Layout::category_t::recipe_ids)>; c++)
+                    {
+                        const auto rid = categories[r][pidx].recipe_ids[c];
+                        if (rid == 0)
+                            continue;
+
+                        const auto ridx = recipes[r][rid].name_index;
+                        if (ridx == 0)
+                            continue;
+
+                        const auto recipe = recipes[r][rid];
+
+                        if (std::ranges::all_of(recipe.materials, [](auto m) -> bool { return m.count == 0; }))
+                            continue;
+
+                        craft_extract::craft_t craft{};
+                        craft.name_index_realm      = r;
+                        craft.name_index_profession = p_nindex;
+                        craft.name_index_category   = cidx;
+                        craft.name_index_recipe     = ridx;
+                        craft.base_material         = recipe.base_material;
+                        craft.icon                  = recipe.icon;
+                        craft.id                    = recipe.id;
+                        craft.level                 = recipe.level;
+                        craft.material_level        = recipe.material_level;
+                        craft.skill                 = recipe.skill;
+
+                        for (const auto mat : recipe.materials)
+                        {
+                            if (mat.count == 0)
+                                continue;
+
+                            craft_extract::craftmaterial_t material{};
+                            material.base_material = mat.base_material;
+                            material.count         = mat.count;
+                            material.name_index    = mat.name_index;
+
+                            craft.materials.push_back(material);
+                        }
+
+                        result.crafts[r].push_back(craft);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Returns the average time, in milliseconds, of the given number of calls to the given function.
+     */
+    template<typename Fn>
+    double measure(const uint32_t iterations, Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (auto x = 0u; x < iterations; x++)
+            fn();
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+
+} // namespace
+
+int32_t main(int32_t argc, char* argv[])
+{
+    const auto iterations = argc > 1 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[1]))) : 200u;
+
+    // Prepare the input file..
+    std::string path;
+    if (argc > 2)
+        path = argv[2];
+    else
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "craft_extract_tests" / "benchmark";
+        std::filesystem::create_directories(dir);
+
+        path = (dir / "sample.crf").string();
+        if (!tests::write<v66>(path, tests::sample(40, 40)))
+        {
+            std::cout << "[!] Error: Failed to write the sample file." << std::endl;
+            return 1;
+        }
+    }
+
+    std::shared_ptr<craft_extract::mapped_file> file;
+    uint32_t version = 0;
+
+    if (!craft_extract::map(path, file, version))
+        return 1;
+
+    return craft_extract::layouts::dispatch(version, [&]<typename Layout>(std::type_identity<Layout>) {
+        const auto data = file->span();
+
+        craft_extract::parse_options sequential{};
+        sequential.parallel_realms = false;
+
+        craft_extract::parse_options parallel{};
+        parallel.parallel_realms = true;
+
+        // Ensure both traversals produce the same recipes..
+        craft_extract::parse_result expected, actual;
+        if (!reference_parse<Layout>(data, expected) || !craft_extract::parser::parse<Layout>(data, sequential, actual))
+            return false;
+
+        if (tests::describe(expected) != tests::describe(actual))
+        {
+            std::cout << "[!] Error: The parser and reference traversal produced different recipes." << std::endl;
+            return false;
+        }
+
+        auto count = 0u;
+        for (const auto& r : actual.crafts)
+            count += static_cast<uint32_t>(r.second.size());
+
+        std::cout << std::format("[*] {} ({} bytes, {} recipes), {} iterations..", path, data.size(), count, iterations) << std::endl;
+
+        craft_extract::parse_result result;
+        const auto reference = measure(iterations, [&] { reference_parse<Layout>(data, result); });
+        const auto plan      = measure(iterations, [&] { craft_extract::parser::parse<Layout>(data, sequential, result); });
+        const auto threaded  = measure(iterations, [&] { craft_extract::parser::parse<Layout>(data, parallel, result); });
+
+        std::cout << std::format("[*] reference (map lookups): {:8.3f} ms/parse", reference) << std::endl;
+        std::cout << std::format("[*] plan (sequential)      : {:8.3f} ms/parse ({:.2f}x)", plan, reference / plan) << std::endl;
+        std::cout << std::format("[*] plan (parallel realms) : {:8.3f} ms/parse ({:.2f}x)", threaded, reference / threaded) << std::endl;
+
+        return true;
+    }) ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "loader.hpp"
+#include "recipe_reader.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+    using v67 = craft_extract::parser::v67::layout_t;
+
+    const auto dir = tests::workdir("parser");
+
+    /**
+     * Writes the given craft file description in the given layout and parses it.
+     */
+    template<typename Layout>
+    bool parse(const tests::file_spec& spec, const craft_extract::parse_options& options, craft_extract::parse_result& result)
+    {
+        const auto path = (dir / std::format("{:x}.crf", Layout::version)).string();
+        return tests::write<Layout>(path, spec) && craft_extract::load(path, options, result);
+    }
+
+    /**
+     * Returns the number of recipes of the given parsed craft information.
+     */
+    std::size_t count(const craft_extract::parse_result& result)
+    {
+        std::size_t total = 0;
+        for (const auto& r : result.crafts)
+            total += r.second.size();
+
+        return total;
+    }
+
+    void test_layouts_match(void)
+    {
+        const auto spec = tests::sample(4, 6);
+
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+        CHECK(parse<v66>(spec, {}, lhs));
+        CHECK(parse<v67>(spec, {}, rhs));
+
+        CHECK(lhs.version == 0x66);
+        CHECK(rhs.version == 0x67);
+
+        // Three professions of four categories of six recipes in each realm, plus the recipe listed twice..
+        CHECK(count(lhs) == 3 * (3 * 4 * 6 + 1));
+        CHECK(tests::describe(lhs) == tests::describe(rhs));
+    }
+
+    void test_parallel_matches_sequential(void)
+    {
+        const auto spec = tests::sample(8, 10);
+
+        craft_extract::parse_options sequential{};
+        sequential.parallel_realms = false;
+
+        craft_extract::parse_result lhs;
+        craft_extract::parse_result rhs;
+        CHECK(parse<v67>(spec, {}, lhs));
+        CHECK(parse<v67>(spec, sequential, rhs));
+
+        CHECK(tests::describe(lhs) == tests::describe(rhs));
+    }
+
+    void test_sink_matches_parse(void)
+    {
+        const auto spec = tests::sample(200, 49);
+
+        craft_extract::parse_result expected;
+        CHECK(parse<v67>(spec, {}, expected));
+        CHECK(count(expected) > craft_extract::craft_batch_size);
+
+        std::vector<craft_extract::craft_t> crafts;
+        auto batches = 0u;
+
+        craft_extract::parse_options options{};
+        options.sink = [&](const uint32_t realm, std::vector<craft_extract::craft_t>&& batch) {
+            CHECK(batch.size() <= craft_extract::craft_batch_size);
+            CHECK(std::ranges::all_of(batch, [realm](const auto& c) { return c.name_index_realm == realm; }));
+
+            crafts.insert(crafts.end(), batch.begin(), batch.end());
+            batches++;
+            return true;
+        };
+
+        craft_extract::parse_result result;
+        CHECK(parse<v67>(spec, options, result));
+        CHECK(result.crafts.empty());
+        CHECK(batches > 3);
+
+        std::vector<std::string> streamed;
+        for (const auto& c : crafts)
+            streamed.push_back(tests::describe([&result](const uint32_t index) { return result.strings[index]; }, c));
+
+        CHECK(streamed == tests::describe(expected));
+    }
+
+    void test_reader_matches_parse(void)
+    {
+        const auto spec = tests::sample(5, 7);
+
+        for (const auto& path : {dir / "reader.66.crf", dir / "reader.67.crf"})
+        {
+            CHECK(path.string().ends_with("66.crf") ? tests::write<v66>(path, spec) : tests::write<v67>(path, spec));
+
+            craft_extract::parse_result expected;
+            CHECK(craft_extract::load(path.string(), {}, expected));
+
+            craft_extract::recipe_reader reader;
+            CHECK(reader.open(path.string()));
+
+            std::vector<std::string> read;
+            for (const auto& c : reader)
+                read.push_back(tests::describe([&reader](const uint32_t index) { return reader.strings()[index]; }, c));
+
+            CHECK(read == tests::describe(expected));
+        }
+    }
+
+    void test_filters(void)
+    {
+        const auto spec = tests::sample(4, 6);
+
+        craft_extract::parse_result all;
+        CHECK(parse<v67>(spec, {}, all));
+
+        craft_extract::parse_options realm{};
+        realm.realm = 1;
+
+        craft_extract::parse_result result;
+        CHECK(parse<v67>(spec, realm, result));
+        CHECK(result.filtered);
+        CHECK(result.crafts.size() == 1 && result.crafts.contains(1));
+        CHECK(result.crafts[1].size() == all.crafts[1].size());
+
+        craft_extract::parse_options profession{};
+        profession.profession = "Armorcraft";
+
+        CHECK(parse<v67>(spec, profession, result));
+        CHECK(count(result) == 3 * 4 * 6);
+        CHECK(std::ranges::all_of(result.crafts, [&result](const auto& r) {
+            return std::ranges::all_of(r.second, [&result](const auto& c) { return result.strings[c.name_index_profession] == "Armorcraft"; });
+        }));
+
+        craft_extract::parse_options skill{};
+        skill.min_skill = 200;
+        skill.max_skill = 400;
+
+        CHECK(parse<v67>(spec, skill, result));
+        CHECK(count(result) > 0 && count(result) < count(all));
+        CHECK(std::ranges::all_of(result.crafts, [](const auto& r) {
+            return std::ranges::all_of(r.second, [](const auto& c) { return c.skill >= 200 && c.skill <= 400; });
+        }));
+
+        CHECK(!all.filtered);
+    }
+
+    void test_corrupt_names_skipped(void)
+    {
+        auto spec = tests::sample(2, 4);
+
+        const auto size = static_cast<uint32_t>(spec.strings.size());
+        spec.realms[0].recipes[1].name_index              = size;
+        spec.realms[1].recipes[2].materials[0].name_index = size + 100;
+        spec.realms[2].categories[0].name_index           = 0xFFFFFF;
+
+        craft_extract::parse_result result;
+        CHECK(parse<v66>(spec, {}, result));
+
+        // One recipe of the first two realms is skipped, as is the first category of the last realm..
+        CHECK(result.crafts[0].size() == 3 * 2 * 4);
+        CHECK(result.crafts[1].size() == 3 * 2 * 4);
+        CHECK(result.crafts[2].size() == 3 * 2 * 4 + 1 - 4);
+
+        CHECK(result.strings[size].empty());
+        CHECK(result.strings.str(size + 100).empty());
+
+        craft_extract::recipe_reader reader;
+        CHECK(reader.open((dir / "66.crf").string()));
+        CHECK(static_cast<std::size_t>(std::ranges::distance(reader)) == count(result));
+    }
+
+    void test_invalid_files_rejected(void)
+    {
+        const auto data = tests::build<v67>(tests::sample(1, 1));
+
+        // Truncated files..
+        const auto path = dir / "truncated.crf";
+        for (const auto size : {std::size_t{2}, std::size_t{40}, data.size() / 2, data.size() - 1})
+        {
+            std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+            ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(size));
+            ofs.close();
+
+            craft_extract::parse_result result;
+            CHECK(!craft_extract::load(path.string(), {}, result));
+        }
+
+        // Unsupported header versions..
+        auto copy = data;
+        copy[0]   = 0x65;
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(copy.data()), static_cast<std::streamsize>(copy.size()));
+        ofs.close();
+
+        craft_extract::parse_result result;
+        CHECK(!craft_extract::load(path.string(), {}, result));
+        CHECK(!craft_extract::load((dir / "missing.crf").string(), {}, result));
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("layouts_match", test_layouts_match);
+    tests::run("parallel_matches_sequential", test_parallel_matches_sequential);
+    tests::run("sink_matches_parse", test_sink_matches_parse);
+    tests::run("reader_matches_parse", test_reader_matches_parse);
+    tests::run("filters", test_filters);
+    tests::run("corrupt_names_skipped", test_corrupt_names_skipped);
+    tests::run("invalid_files_rejected", test_invalid_files_rejected);
+
+    return tests::finish();
+}
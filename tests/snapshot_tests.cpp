@@ -0,0 +1,156 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "loader.hpp"
+#include "snapshot.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+    using v67 = craft_extract::parser::v67::layout_t;
+
+    const auto dir = tests::workdir("snapshot");
+
+    /**
+     * Returns every recipe of the given snapshot, as described by tests::describe.
+     */
+    std::vector<std::string> describe(const craft_extract::snapshot::view& snapshot)
+    {
+        const auto strings = [&snapshot](const uint32_t index) { return snapshot.string(index); };
+
+        std::vector<std::string> crafts;
+        for (const auto& recipe : snapshot.recipes())
+        {
+            craft_extract::craft_t craft{};
+            craft.name_index_realm      = recipe.name_index_realm;
+            craft.name_index_profession = recipe.name_index_profession;
+            craft.name_index_category   = recipe.name_index_category;
+            craft.name_index_recipe     = recipe.name_index_recipe;
+            craft.base_material         = recipe.base_material;
+            craft.icon                  = recipe.icon;
+            craft.id                    = recipe.id;
+            craft.level                 = recipe.level;
+            craft.material_level        = recipe.material_level;
+            craft.skill                 = recipe.skill;
+
+            for (const auto& m : snapshot.materials(recipe))
+                craft.materials.push_back({m.base_material, m.count, m.name_index});
+
+            crafts.push_back(tests::describe(strings, craft));
+        }
+
+        return crafts;
+    }
+
+    template<typename Layout>
+    void test_round_trip(void)
+    {
+        const auto source = (dir / std::format("{:x}.crf", Layout::version)).string();
+        const auto path   = (dir / std::format("{:x}.crfx", Layout::version)).string();
+
+        CHECK(tests::write<Layout>(source, tests::sample(6, 8)));
+
+        craft_extract::parse_result result;
+        CHECK(craft_extract::load(source, {}, result));
+        CHECK(craft_extract::snapshot::save(result, path));
+
+        craft_extract::snapshot::view snapshot;
+        CHECK(snapshot.open(path, source));
+        CHECK(snapshot.source_version() == Layout::version);
+        CHECK(snapshot.recipes().size() == 3 * (3 * 6 * 8 + 1));
+        CHECK(describe(snapshot) == tests::describe(result));
+
+        // The recorded hash is that of the parsed source file..
+        uint64_t hash = 0;
+        CHECK(craft_extract::cache::hash_file(source, hash) && hash == snapshot.source_hash());
+    }
+
+    void test_stale_source(void)
+    {
+        const auto source = (dir / "stale.crf").string();
+        const auto path   = (dir / "stale.crfx").string();
+        const auto spec   = tests::sample(2, 3);
+
+        CHECK(tests::write<v67>(source, spec));
+
+        craft_extract::parse_result result;
+        CHECK(craft_extract::load(source, {}, result));
+        CHECK(craft_extract::snapshot::save(result, path));
+        result.clear();
+
+        // Changing the source file invalidates the snapshot..
+        auto changed = spec;
+        changed.realms[2].recipes[0].icon++;
+        CHECK(tests::write<v67>(source, changed));
+
+        craft_extract::snapshot::view snapshot;
+        CHECK(!snapshot.open(path, source));
+        CHECK(snapshot.recipes().empty());
+
+        // The snapshot itself remains readable when its source is not checked..
+        CHECK(snapshot.open(path));
+        CHECK(snapshot.recipes().size() == 3 * (3 * 2 * 3 + 1));
+    }
+
+    void test_filtered_refused(void)
+    {
+        const auto source = (dir / "filtered.crf").string();
+        const auto path   = dir / "filtered.crfx";
+
+        CHECK(tests::write<v67>(source, tests::sample(2, 3)));
+
+        craft_extract::parse_options options{};
+        options.realm = 0;
+
+        craft_extract::parse_result result;
+        CHECK(craft_extract::load(source, options, result));
+        CHECK(!craft_extract::snapshot::save(result, path.string()));
+        CHECK(!std::filesystem::exists(path));
+    }
+
+    void test_invalid_snapshots(void)
+    {
+        const auto path = (dir / "invalid.crfx").string();
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << "CRFX";
+        ofs.close();
+
+        craft_extract::snapshot::view snapshot;
+        CHECK(!snapshot.open(path));
+        CHECK(!snapshot.open((dir / "missing.crfx").string()));
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("round_trip_v66", test_round_trip<v66>);
+    tests::run("round_trip_v67", test_round_trip<v67>);
+    tests::run("stale_source", test_stale_source);
+    tests::run("filtered_refused", test_filtered_refused);
+    tests::run("invalid_snapshots", test_invalid_snapshots);
+
+    return tests::finish();
+}
@@ -0,0 +1,236 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "loader.hpp"
+
+#include <SQLiteCpp/SQLiteCpp.h>
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+
+    const auto dir = tests::workdir("sqlite_ext");
+
+    /**
+     * The path to the crf extension module, given on the command line.
+     */
+    std::string extension;
+
+    /**
+     * Returns an in-memory database with the crf extension loaded.
+     */
+    std::unique_ptr<SQLite::Database> open(void)
+    {
+        auto db = std::make_unique<SQLite::Database>(":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+        db->loadExtension(extension.c_str(), nullptr);
+        return db;
+    }
+
+    /**
+     * Returns the recipes of the given query, as described by tests::describe without their materials.
+     */
+    std::vector<std::string> recipes(SQLite::Database& db, const std::string& where)
+    {
+        SQLite::Statement query(db, "SELECT realm_id, profession, category, name, base_material, icon, id, level, material_level, skill FROM crf_recipes(?) " + where);
+        query.bind(1, (dir / "sample.crf").string());
+
+        std::vector<std::string> rows;
+        while (query.executeStep())
+        {
+            rows.push_back(std::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+                query.getColumn(0).getInt(),
+                query.getColumn(1).getString(),
+                query.getColumn(2).getString(),
+                query.getColumn(3).getString(),
+                query.getColumn(4).getInt(),
+                query.getColumn(5).getInt(),
+                query.getColumn(6).getInt64(),
+                query.getColumn(7).getInt(),
+                query.getColumn(8).getInt(),
+                query.getColumn(9).getInt()));
+        }
+
+        return rows;
+    }
+
+    /**
+     * Returns the recipes of the given parse options, loaded directly, as described by tests::describe without their materials.
+     */
+    std::vector<std::string> expected(const craft_extract::parse_options& options)
+    {
+        craft_extract::parse_result result;
+        CHECK(craft_extract::load((dir / "sample.crf").string(), options, result));
+
+        std::vector<std::string> rows;
+        for (auto row : tests::describe(result))
+        {
+            // Strip the materials of each recipe..
+            auto end = row.begin();
+            for (auto x = 0; x < 10 && end != row.end(); x++)
+                end = std::find(end + (x == 0 ? 0 : 1), row.end(), '|');
+
+            rows.emplace_back(row.begin(), end);
+        }
+
+        return rows;
+    }
+
+    void test_recipes(void)
+    {
+        auto db = open();
+
+        CHECK(recipes(*db, "") == expected({}));
+        CHECK(recipes(*db, "").size() == 3 * (3 * 3 * 4 + 1));
+    }
+
+    void test_pushdown(void)
+    {
+        auto db = open();
+
+        craft_extract::parse_options realm{};
+        realm.realm = 1;
+
+        craft_extract::parse_options profession{};
+        profession.realm      = 2;
+        profession.profession = "Tailoring";
+
+        craft_extract::parse_options category{};
+        category.realm      = 0;
+        category.profession = "Armorcraft";
+        category.category   = "Category 0-1-2";
+
+        CHECK(recipes(*db, "WHERE realm_id = 1") == expected(realm));
+        CHECK(recipes(*db, "WHERE realm_id = 2 AND profession = 'Tailoring'") == expected(profession));
+        CHECK(recipes(*db, "WHERE realm_id = 0 AND profession = 'Armorcraft' AND category = 'Category 0-1-2'") == expected(category));
+        CHECK(expected(category).size() == 4);
+
+        // Non-integer realm values are checked by SQLite instead of the parser..
+        CHECK(recipes(*db, "WHERE realm_id = 1.0") == expected(realm));
+        CHECK(recipes(*db, "WHERE realm_id = '1'") == expected(realm));
+        CHECK(recipes(*db, "WHERE realm_id = 5").empty());
+        CHECK(recipes(*db, "WHERE profession = 'Unknown'").empty());
+    }
+
+    void test_materials(void)
+    {
+        auto db = open();
+
+        craft_extract::parse_result result;
+        CHECK(craft_extract::load((dir / "sample.crf").string(), {}, result));
+
+        std::vector<std::string> expected;
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+            {
+                for (auto x = 0u; x < craft.materials.size(); x++)
+                    expected.push_back(std::format("{}|{}|{}|{}x{}:{}", r.first, craft.id, x, craft.materials[x].count, result.strings[craft.materials[x].name_index], craft.materials[x].base_material));
+            }
+        }
+
+        SQLite::Statement query(*db, "SELECT realm_id, recipe_id, slot, count, name, base_material FROM crf_materials(?)");
+        query.bind(1, (dir / "sample.crf").string());
+
+        std::vector<std::string> rows;
+        while (query.executeStep())
+            rows.push_back(std::format("{}|{}|{}|{}x{}:{}", query.getColumn(0).getInt(), query.getColumn(1).getInt64(), query.getColumn(2).getInt(), query.getColumn(3).getInt(), query.getColumn(4).getString(), query.getColumn(5).getInt()));
+
+        CHECK(rows == expected);
+
+        // Join the materials of each recipe back onto it..
+        SQLite::Statement join(*db, "SELECT COUNT(*) FROM crf_recipes(?1) AS r JOIN crf_materials(?1) AS m ON m.realm_id = r.realm_id AND m.recipe_id = r.id WHERE r.realm_id = 0 AND r.profession = 'Weaponcraft'");
+        join.bind(1, (dir / "sample.crf").string());
+
+        auto joined = 0u;
+        for (const auto& craft : result.crafts[0])
+        {
+            if (result.strings[craft.name_index_profession] != "Weaponcraft")
+                continue;
+
+            for (const auto& other : result.crafts[0])
+            {
+                if (other.id == craft.id)
+                    joined += static_cast<uint32_t>(other.materials.size());
+            }
+        }
+
+        CHECK(joined > 0);
+        CHECK(join.executeStep() && join.getColumn(0).getUInt() == joined);
+    }
+
+    void test_errors(void)
+    {
+        auto db = open();
+
+        const auto fails = [&db](const std::string& sql, const std::string& message) {
+            try
+            {
+                SQLite::Statement query(*db, sql);
+                while (query.executeStep())
+                    ;
+            }
+            catch (const SQLite::Exception& e)
+            {
+                return std::string(e.what()).find(message) != std::string::npos;
+            }
+
+            return false;
+        };
+
+        // The file argument is required..
+        CHECK(fails("SELECT * FROM crf_recipes", "no query solution"));
+
+        // Parse errors are reported through the virtual table..
+        CHECK(fails(std::format("SELECT * FROM crf_recipes('{}')", (dir / "missing.crf").string()), "failed to parse crf file"));
+
+        // The tables cannot be used from views..
+        db->exec(std::format("CREATE VIEW v AS SELECT * FROM crf_recipes('{}')", (dir / "sample.crf").string()));
+        CHECK(fails("SELECT * FROM v", "unsafe use of virtual table"));
+    }
+
+} // namespace
+
+int32_t main(int32_t argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "[!] Error: Usage: sqlite_ext_tests <crf extension module>" << std::endl;
+        return 1;
+    }
+
+    extension = argv[1];
+
+    if (!tests::write<v66>(dir / "sample.crf", tests::sample(3, 4)))
+    {
+        std::cout << "[!] Error: Failed to write the sample file." << std::endl;
+        return 1;
+    }
+
+    tests::run("recipes", test_recipes);
+    tests::run("pushdown", test_pushdown);
+    tests::run("materials", test_materials);
+    tests::run("errors", test_errors);
+
+    return tests::finish();
+}
@@ -0,0 +1,274 @@
+/**
+ * craft_extract - Copyright (c) 2022 atom0s [atom0s@live.com]
+ *
+ * This file is part of craft_extract.
+ *
+ * craft_extract is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * craft_extract is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with craft_extract.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "defines.hpp"
+#include "check.hpp"
+#include "craft_file.hpp"
+#include "json.hpp"
+#include "extract.hpp"
+
+namespace
+{
+    namespace tests = craft_extract::tests;
+
+    using v66 = craft_extract::parser::v66::layout_t;
+
+    const auto dir = tests::workdir("writers");
+
+    /**
+     * Returns the sample craft file description, with names that must be escaped or quoted by the writers.
+     */
+    tests::file_spec sample(void)
+    {
+        auto spec = tests::sample(3, 4);
+
+        for (auto& str : spec.strings)
+        {
+            if (str == "Recipe 1")
+                str = "Recipe \"1\" \\ back\\slash";
+            else if (str == "Recipe 2")
+                str = std::string("Recipe\t2\r\n\b\f\x01\x1f", 16);
+            else if (str == "Material 3")
+                str = "Mat\xC3\xA9riau \"3\"";
+            else if (str == "Category 1-2-0")
+                str = "Category/\x7F 1-2-0";
+        }
+
+        return spec;
+    }
+
+    /**
+     * Parses the sample craft file.
+     */
+    bool parse(craft_extract::parse_result& result)
+    {
+        const auto path = (dir / "sample.crf").string();
+        return tests::write<v66>(path, sample()) && craft_extract::load(path, {}, result);
+    }
+
+    /**
+     * Returns the contents of the given file.
+     */
+    std::string read(const std::filesystem::path& path)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Returns the given parsed craft information as a JSON document, built with nlohmann::json.
+     */
+    std::string reference_json(const craft_extract::parse_result& result)
+    {
+        nlohmann::json j;
+
+        for (const auto& r : result.crafts)
+        {
+            j[craft_extract::realm_names[r.first]] = {};
+
+            for (const auto& craft : r.second)
+            {
+                nlohmann::json recipe;
+                recipe["profession"]         = result.strings.str(craft.name_index_profession);
+                recipe["category"]           = result.strings.str(craft.name_index_category);
+                recipe["name"]               = result.strings.str(craft.name_index_recipe);
+                recipe["base_material_name"] = std::string(craft_extract::base_material_name(craft.base_material));
+                recipe["base_material"]      = craft.base_material;
+                recipe["icon"]               = craft.icon;
+                recipe["id"]                 = craft.id;
+                recipe["level"]              = craft.level;
+                recipe["material_level"]     = craft.material_level;
+                recipe["skill"]              = craft.skill;
+                recipe["materials"]          = {};
+
+                for (const auto& m : craft.materials)
+                {
+                    nlohmann::json mat;
+                    mat["base_material_name"] = std::string(craft_extract::base_material_name(m.base_material));
+                    mat["base_material"]      = m.base_material;
+                    mat["count"]              = m.count;
+                    mat["name"]               = result.strings.str(m.name_index);
+
+                    recipe["materials"] += mat;
+                }
+
+                j[craft_extract::realm_names[r.first]] += recipe;
+            }
+        }
+
+        return j.dump(2);
+    }
+
+    void test_json(void)
+    {
+        craft_extract::parse_result result;
+        CHECK(parse(result));
+        CHECK(craft_extract::writers::save_json(result, (dir / "sample.json").string()));
+        CHECK(read(dir / "sample.json") == reference_json(result));
+
+        // Results with a single realm and no recipes..
+        craft_extract::parse_result filtered;
+        CHECK(parse(filtered));
+
+        filtered.crafts.erase(0);
+        filtered.crafts.erase(1);
+
+        CHECK(craft_extract::writers::save_json(filtered, (dir / "filtered.json").string()));
+        CHECK(read(dir / "filtered.json") == reference_json(filtered));
+
+        craft_extract::parse_result empty;
+        CHECK(craft_extract::writers::save_json(empty, (dir / "empty.json").string()));
+        CHECK(read(dir / "empty.json") == reference_json(empty));
+    }
+
+    void test_csv(void)
+    {
+        craft_extract::parse_result result;
+        CHECK(parse(result));
+        CHECK(craft_extract::writers::save_csv(result, (dir / "sample.csv").string()));
+
+        std::vector<std::string> expected;
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+            {
+                auto row = std::format("{},{},{},{},{},{},{},{},{},{},{},{}",
+                    craft.id,
+                    r.first,
+                    craft_extract::realm_names[r.first],
+                    result.strings[craft.name_index_profession],
+                    result.strings[craft.name_index_category],
+                    result.strings[craft.name_index_recipe],
+                    craft.base_material,
+                    craft_extract::base_material_name(craft.base_material),
+                    craft.icon,
+                    craft.level,
+                    craft.material_level,
+                    craft.skill);
+
+                for (const auto& m : craft.materials)
+                    row += std::format(",{},{},{},{}", m.base_material, craft_extract::base_material_name(m.base_material), m.count, result.strings[m.name_index]);
+
+                expected.push_back(row);
+            }
+        }
+
+        // Split the output into rows; recipe names may contain line breaks, so rows are counted from the recipes..
+        const auto csv = read(dir / "sample.csv");
+        const auto eol = csv.find('\n');
+        CHECK(eol != std::string::npos && csv.substr(0, eol).starts_with("id, realm, realm_name, profession,"));
+
+        std::string rows;
+        for (const auto& row : expected)
+            rows += row + "\n";
+
+        CHECK(csv.substr(eol + 1) == rows);
+        CHECK(expected.size() == 3 * (3 * 3 * 4 + 1));
+    }
+
+    /**
+     * Returns the integer result of the given query.
+     */
+    int64_t query(const std::filesystem::path& path, const std::string& sql)
+    {
+        SQLite::Database db(path.string(), SQLite::OPEN_READONLY);
+        return db.execAndGet(sql).getInt64();
+    }
+
+    void test_sqlite(void)
+    {
+        craft_extract::parse_result result;
+        CHECK(parse(result));
+
+        const auto path = dir / "sample.sqlite";
+        CHECK(craft_extract::writers::save_sqlite(result, path.string()));
+
+        std::vector<std::string> names;
+        auto materials = 0u;
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+            {
+                names.push_back(result.strings.str(craft.name_index_recipe));
+                materials += static_cast<uint32_t>(craft.materials.size());
+            }
+        }
+
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes") == static_cast<int64_t>(names.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes_materials") == materials);
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes WHERE typeof(profession) <> 'text' OR typeof(category) <> 'text' OR typeof(name) <> 'text'") == 0);
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes_materials WHERE typeof(name) <> 'text'") == 0);
+        CHECK(query(path, "SELECT COUNT(*) FROM realms") == static_cast<int64_t>(craft_extract::realm_names.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM base_materials") == static_cast<int64_t>(craft_extract::base_materials.size()));
+
+        // Names are stored as given..
+        SQLite::Database db(path.string(), SQLite::OPEN_READONLY);
+        SQLite::Statement select(db, "SELECT name FROM recipes ORDER BY rowid");
+
+        std::vector<std::string> stored;
+        while (select.executeStep())
+            stored.push_back(select.getColumn(0).getString());
+
+        CHECK(stored == names);
+    }
+
+    void test_sqlite_normalized(void)
+    {
+        craft_extract::parse_result result;
+        CHECK(parse(result));
+
+        const auto path = dir / "sample.sqlnorm.sqlite";
+        CHECK(craft_extract::writers::save_sqlite_normalized(result, path.string()));
+
+        // Recipes are keyed by realm, profession, category and id; materials by realm, recipe id and slot..
+        std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> recipes;
+        std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> materials;
+        for (const auto& r : result.crafts)
+        {
+            for (const auto& craft : r.second)
+            {
+                recipes.emplace_back(r.first, craft.name_index_profession, craft.name_index_category, craft.id);
+                for (auto x = 0u; x < craft.materials.size(); x++)
+                    materials.emplace_back(r.first, craft.id, x);
+            }
+        }
+
+        std::ranges::sort(recipes);
+        std::ranges::sort(materials);
+        recipes.erase(std::ranges::unique(recipes).begin(), recipes.end());
+        materials.erase(std::ranges::unique(materials).begin(), materials.end());
+
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes") == static_cast<int64_t>(recipes.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes_materials") == static_cast<int64_t>(materials.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM strings") == static_cast<int64_t>(result.strings.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes_named") == static_cast<int64_t>(recipes.size()));
+        CHECK(query(path, "SELECT COUNT(*) FROM recipes_named WHERE name = 'Recipe \"1\" \\ back\\slash'") > 0);
+    }
+
+} // namespace
+
+int32_t main(void)
+{
+    tests::run("json", test_json);
+    tests::run("csv", test_csv);
+    tests::run("sqlite", test_sqlite);
+    tests::run("sqlite_normalized", test_sqlite_normalized);
+
+    return tests::finish();
+}